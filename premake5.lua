@@ -120,6 +120,14 @@ newoption {
    allowed     = { { "true", "True"}, { "false", "False" } }
 }
 
+newoption {
+   trigger     = "embed-stdlib",
+   description = "(Optional) If true the serialized stdlib in source/slang/slang-stdlib-generated.h (produced via slangc -save-stdlib-bin-source) is embedded in slang",
+   value       = "bool",
+   default     = "false",
+   allowed     = { { "true", "True"}, { "false", "False" } }
+}
+
 buildLocation = _OPTIONS["build-location"]
 executeBinary = (_OPTIONS["execute-binary"] == "true")
 targetDetail = _OPTIONS["target-detail"]
@@ -129,6 +137,7 @@ enableProfile = (_OPTIONS["enable-profile"] == "true")
 optixPath = _OPTIONS["optix-sdk-path"]
 enableOptix = not not (_OPTIONS["enable-optix"] == "true" or optixPath)
 enableProfile = (_OPTIONS["enable-profile"] == "true")
+embedStdLib = (_OPTIONS["embed-stdlib"] == "true")
 
 if enableOptix then
     optixPath = optixPath or "C:/ProgramData/NVIDIA Corporation/OptiX SDK 7.0.0/"
@@ -608,6 +617,10 @@ tool "slang-test"
     includedirs { "." }
     links { "core", "slang" }
 
+    -- Some of the unit tests compile on multiple threads
+    filter { "system:linux" }
+        links { "pthread" }
+
 --
 -- The reflection test harness `slang-reflection-test` is pretty
 -- simple, in that it only needs to link against the slang library
@@ -902,6 +915,13 @@ standardProject "slang"
     -- which produces the appropriate source 
     
     dependson { "run-generators" }
+
+    -- If enabled, the serialized stdlib is loaded on session creation instead of
+    -- compiling the stdlib from source. The header holding it must be generated
+    -- beforehand with `slangc -save-stdlib-bin-source` (see docs/building.md).
+    if embedStdLib then
+        defines { "SLANG_EMBED_STDLIB=1" }
+    end
     
     -- If we are not building glslang from source, then be
     -- sure to copy a binary copy over to the output directory
@@ -920,6 +940,8 @@ standardProject "slang"
     filter { "system:linux" }
         -- might be able to do pic(true)
         buildoptions{"-fPIC"}
+        -- Code generation can run on multiple threads
+        links { "pthread" }
        
     
 if enableProfile then
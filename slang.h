@@ -1215,6 +1215,18 @@ extern "C"
         SlangCompileRequest*    request,
         SlangLineDirectiveMode  mode);
 
+    /*!
+    @brief Set how many threads to use when generating code for the request's (target, entry point) pairs.
+    @param request The compilation context.
+    @param threadCount The maximum number of threads to use. 1 (the default) generates code serially on
+    the calling thread. 0 uses as many threads as the hardware supports.
+
+    Code generated in parallel, and the order of diagnostics, is the same as when generating serially.
+    */
+    SLANG_API void spSetBackEndThreadCount(
+        SlangCompileRequest*    request,
+        int                     threadCount);
+
     /*!
     @brief Sets the target for code generation.
     @param request The compilation context.
@@ -1382,6 +1394,51 @@ extern "C"
         const char*             key,
         const char*             value);
 
+    /** Add a permutation, a set of macro definitions the request is compiled with.
+
+    @param request The compile request.
+    @return The zero-based index of the permutation.
+
+    If a request has permutations, `spCompile` compiles the request once for each
+    permutation, with the permutation's definitions added to the request's own. The
+    permutations share the work that doesn't depend on the definitions: source files
+    are only read once, included files are only lexed once, and imported modules are
+    only checked once. The code for the permutations is generated in parallel, on up to
+    the number of threads set with `spSetBackEndThreadCount`.
+
+    The output for each permutation is accessed through the request returned by
+    `spGetPermutationRequest`. The diagnostic output of `request` holds the diagnostics
+    for all of the permutations, in order.
+    */
+    SLANG_API int spAddPermutation(
+        SlangCompileRequest*    request);
+
+    /** Add a macro definition to a permutation.
+
+    @param permutationIndex The index of the permutation (see `spAddPermutation`).
+    @param key The name of the macro to define.
+    @param value The value of the macro to define.
+    */
+    SLANG_API void spPermutation_addPreprocessorDefine(
+        SlangCompileRequest*    request,
+        int                     permutationIndex,
+        const char*             key,
+        const char*             value);
+
+    /** Get the number of permutations added to the request. */
+    SLANG_API int spGetPermutationCount(
+        SlangCompileRequest*    request);
+
+    /** Get the request holding the output of a permutation, once `request` has been compiled.
+
+    The returned request can be used with the functions that get output from a request
+    (such as `spGetEntryPointCodeBlob` and `spGetDiagnosticOutput`). It is owned by `request`,
+    and is only valid until `request` is destroyed or compiled again. Returns nullptr
+    if the permutation wasn't compiled.
+    */
+    SLANG_API SlangCompileRequest* spGetPermutationRequest(
+        SlangCompileRequest*    request,
+        int                     permutationIndex);
 
     /** Add a source file to the given translation unit.
 
@@ -2827,15 +2884,32 @@ namespace slang
     struct SpecializationArg;
     struct TargetDesc;
 
+        /** Statistics about use of the downstream compile cache, since it was set with
+        IGlobalSession::setDownstreamCompileCache.
+        */
+    struct DownstreamCompileCacheStats
+    {
+        SlangInt hitCount = 0;          ///< Downstream compilations whose result was found in the cache
+        SlangInt missCount = 0;         ///< Downstream compilations whose result was not found in the cache
+        SlangInt addCount = 0;          ///< Results added to the cache
+        SlangInt evictionCount = 0;     ///< Results removed from the cache to keep it below the size cap
+    };
+
         /** A global session for interaction with the Slang library.
 
         An application may create and re-use a single global session across
         multiple sessions, in order to amortize startups costs (in current
         Slang this is mostly the cost of loading the Slang standard library).
 
-        The global session is currently *not* thread-safe and objects created from
-        a single global session should only be used from a single thread at
-        a time.
+        Once created (and the standard library is set up) the state the global session
+        holds, such as the standard library, is immutable. Sessions and compile requests
+        created from a single global session can therefore be used on different threads
+        at the same time, with all threads sharing the one copy of the standard library.
+
+        Each session or compile request (and the objects created from it) should only be
+        used from a single thread at a time. Functions that configure the global session
+        (such as `setDownstreamCompilerPath` or `setLanguagePrelude`) are not thread-safe,
+        and should be called before the global session is used on multiple threads.
         */
     struct IGlobalSession : public ISlangUnknown
     {
@@ -2937,6 +3011,54 @@ namespace slang
         virtual SLANG_NO_THROW void SLANG_MCALL getLanguagePrelude(
             SlangSourceLanguage sourceLanguage,
             ISlangBlob** outPrelude) = 0;
+
+            /** Compile the standard library from source.
+
+            Only valid on a session created without a standard library (see slang_createGlobalSessionWithoutStdLib).
+            @return SLANG_OK if the standard library was compiled. Fails if the session already has a standard library.
+            */
+        virtual SLANG_NO_THROW SlangResult SLANG_MCALL compileStdLib() = 0;
+
+            /** Load a standard library previously produced by saveStdLib.
+
+            Only valid on a session created without a standard library (see slang_createGlobalSessionWithoutStdLib).
+            Fails if the data is not valid, or was saved from a different version of the standard library source.
+            In that case the session is left without a standard library, and compileStdLib can be used instead.
+
+            @param stdLib Start of the serialized standard library
+            @param stdLibSizeInBytes The size in bytes of the serialized standard library
+            */
+        virtual SLANG_NO_THROW SlangResult SLANG_MCALL loadStdLib(const void* stdLib, size_t stdLibSizeInBytes) = 0;
+
+            /** Save the checked standard library of the session such that it can be loaded with loadStdLib.
+
+            @param outBlob On success holds the serialized standard library
+            */
+        virtual SLANG_NO_THROW SlangResult SLANG_MCALL saveStdLib(ISlangBlob** outBlob) = 0;
+
+            /** Cache the results of downstream compilers (such as glslang, NVRTC or a C++ compiler) in a directory.
+
+            The result of a downstream compilation is looked up using everything that can change it - the source
+            Slang generated, the downstream compiler and its version, the options it is invoked with and the target
+            profile. If the directory already holds a result for a compilation the downstream compiler is not invoked.
+            The directory can be shared between sessions and processes. Pass-through compilations are not cached.
+
+            Files included by path from downstream source (such as a language prelude that includes a header)
+            are not part of the lookup, so the cache should be cleared if they change.
+
+            Like other configuration functions, this should be called before the global session is used on multiple threads.
+
+            @param directory The directory to hold the cache, created if it doesn't exist. Pass nullptr to stop caching.
+            @param maxSizeInBytes The cap on the total size of the cache. When exceeded the least recently used
+            results are removed. Pass 0 to use the default cap (256MB).
+            */
+        virtual SLANG_NO_THROW SlangResult SLANG_MCALL setDownstreamCompileCache(char const* directory, SlangInt maxSizeInBytes) = 0;
+
+            /** Get statistics about use of the downstream compile cache.
+
+            @return SLANG_E_NOT_AVAILABLE if no cache is set.
+            */
+        virtual SLANG_NO_THROW SlangResult SLANG_MCALL getDownstreamCompileCacheStats(DownstreamCompileCacheStats* outStats) = 0;
     };
 
     #define SLANG_UUID_IGlobalSession { 0xc140b5fd, 0xc78, 0x452e, { 0xba, 0x7c, 0x1a, 0x1e, 0x70, 0xc7, 0xf7, 0x1c } };
@@ -2979,6 +3101,18 @@ namespace slang
         You have been warned.
         */
         kSessionFlag_FalcorCustomSharedKeywordSemantics = 1 << 0,
+
+        /** Reload modules whose source has changed.
+
+        Normally a module is loaded once by a session, and every later `import` of it (or call to
+        `ISession::loadModule`) uses that copy, even if its source files have since been edited.
+        With this flag, the session records a hash of the content of every file each loaded module
+        depends on (including the files of the modules it imports). Each call to `ISession::loadModule`
+        or `ISession::createCompileRequest` re-reads those files, and any module that depends on a
+        file that has changed is discarded, so that it is loaded and checked again the next time it is
+        imported. Modules that don't depend on a changed file (and their IR) are reused.
+        */
+        kSessionFlag_ReloadChangedModules = 1 << 1,
     };
 
     struct PreprocessorMacroDesc
@@ -3313,6 +3447,12 @@ SLANG_API SlangResult slang_createGlobalSession(
     SlangInt                apiVersion,
     slang::IGlobalSession** outGlobalSession);
 
+/* Create a global session that does not have a standard library. Before the session can be used to compile
+code the standard library must be added via either IGlobalSession::compileStdLib or IGlobalSession::loadStdLib. */
+SLANG_API SlangResult slang_createGlobalSessionWithoutStdLib(
+    SlangInt                apiVersion,
+    slang::IGlobalSession** outGlobalSession);
+
 namespace slang
 {
     inline SlangResult createGlobalSession(
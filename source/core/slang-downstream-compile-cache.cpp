@@ -0,0 +1,485 @@
+// slang-downstream-compile-cache.cpp
+#include "slang-downstream-compile-cache.h"
+
+#include "slang-blob.h"
+#include "slang-hash.h"
+#include "slang-io.h"
+#include "slang-riff.h"
+#include "slang-stream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace Slang
+{
+
+namespace { // anonymous
+
+static const char kEntryExtension[] = ".slang-cache";
+static const uint32_t kEntryMagic = SLANG_FOUR_CC('S', 'D', 'C', 'E');
+// Must be changed if the layout of an entry file changes
+static const uint32_t kEntryVersion = 1;
+
+/* Writes the fields of an entry into a byte list. Entries are only read back on the machine that wrote them,
+so values are written in native byte order. */
+struct EntryWriter
+{
+    template <typename T>
+    void write(const T& value) { m_data.addRange((const uint8_t*)&value, sizeof(T)); }
+    void writeBytes(const void* data, size_t size)
+    {
+        write(uint64_t(size));
+        m_data.addRange((const uint8_t*)data, Index(size));
+    }
+    void writeString(const String& string) { writeBytes(string.getBuffer(), size_t(string.getLength())); }
+
+    List<uint8_t> m_data;
+};
+
+struct EntryReader
+{
+    template <typename T>
+    SlangResult read(T& out)
+    {
+        if (m_end - m_cur < ptrdiff_t(sizeof(T)))
+        {
+            return SLANG_FAIL;
+        }
+        ::memcpy(&out, m_cur, sizeof(T));
+        m_cur += sizeof(T);
+        return SLANG_OK;
+    }
+    SlangResult readBytes(const uint8_t*& outData, size_t& outSize)
+    {
+        uint64_t size;
+        SLANG_RETURN_ON_FAIL(read(size));
+        if (uint64_t(m_end - m_cur) < size)
+        {
+            return SLANG_FAIL;
+        }
+        outData = m_cur;
+        outSize = size_t(size);
+        m_cur += size;
+        return SLANG_OK;
+    }
+    SlangResult readString(String& out)
+    {
+        const uint8_t* data;
+        size_t size;
+        SLANG_RETURN_ON_FAIL(readBytes(data, size));
+        out = UnownedStringSlice((const char*)data, size);
+        return SLANG_OK;
+    }
+
+    EntryReader(const uint8_t* data, size_t size):
+        m_cur(data),
+        m_end(data + size)
+    {}
+
+    const uint8_t* m_cur;
+    const uint8_t* m_end;
+};
+
+static SlangResult _readFile(const String& path, List<uint8_t>& outData)
+{
+    uint64_t size;
+    int64_t modificationTime;
+    SLANG_RETURN_ON_FAIL(File::getSizeAndModificationTime(path, size, modificationTime));
+
+    try
+    {
+        FileStream stream(path, FileMode::Open, FileAccess::Read, FileShare::ReadWrite);
+        outData.setCount(Index(size));
+        if (stream.read(outData.getBuffer(), size_t(size)) != size_t(size))
+        {
+            return SLANG_FAIL;
+        }
+    }
+    catch (const IOException&)
+    {
+        // Can happen if the entry was evicted (say by another process) since the size was read
+        return SLANG_E_NOT_FOUND;
+    }
+    return SLANG_OK;
+}
+
+struct EntryVisitor : public Path::Visitor
+{
+    virtual void accept(Path::Type type, const UnownedStringSlice& filename) SLANG_OVERRIDE
+    {
+        if (type == Path::Type::File && filename.endsWith(UnownedStringSlice::fromLiteral(kEntryExtension)))
+        {
+            m_filenames.add(filename);
+        }
+    }
+    List<String> m_filenames;
+};
+
+} // anonymous
+
+/* static */void DownstreamCompileCache::appendKey(const DownstreamCompiler::Desc& desc, const DownstreamCompiler::CompileOptions& options, StringBuilder& out)
+{
+    // Every string is written with its length, so the key can't be ambiguous whatever the strings contain
+    auto appendString = [&](const String& string)
+    {
+        out << string.getLength() << ":" << string << "\n";
+    };
+
+    out << "compiler:" << int(desc.type) << " " << desc.majorVersion << "." << desc.minorVersion << "\n";
+
+    out << "options:" << int(options.optimizationLevel) << " " << int(options.debugInfoType) << " " << int(options.targetType) << " ";
+    out << int(options.sourceLanguage) << " " << int(options.floatingPointMode) << " " << int(options.pipelineType) << " ";
+    out << uint32_t(options.flags) << " " << int(options.platform) << "\n";
+
+    out << "defines:" << options.defines.getCount() << "\n";
+    for (const auto& define : options.defines)
+    {
+        appendString(define.nameWithSig);
+        appendString(define.value);
+    }
+
+    out << "includePaths:" << options.includePaths.getCount() << "\n";
+    for (const auto& path : options.includePaths)
+    {
+        appendString(path);
+    }
+    out << "libraryPaths:" << options.libraryPaths.getCount() << "\n";
+    for (const auto& path : options.libraryPaths)
+    {
+        appendString(path);
+    }
+
+    out << "capabilities:" << options.requiredCapabilityVersions.getCount() << "\n";
+    for (const auto& capability : options.requiredCapabilityVersions)
+    {
+        out << int(capability.kind) << " ";
+        capability.version.append(out);
+        out << "\n";
+    }
+
+    // The path only appears in diagnostics, but they are part of the cached result
+    out << "sourcePath:";
+    appendString(options.sourceContentsPath);
+
+    out << "sourceFiles:" << options.sourceFiles.getCount() << "\n";
+    for (const auto& path : options.sourceFiles)
+    {
+        appendString(path);
+    }
+
+    out << "source:";
+    appendString(options.sourceContents);
+}
+
+/* static */SlangResult DownstreamCompileCache::create(const String& directory, uint64_t maxSizeInBytes, RefPtr<DownstreamCompileCache>& outCache)
+{
+    if (directory.getLength() == 0)
+    {
+        return SLANG_E_INVALID_ARG;
+    }
+
+    SlangPathType pathType;
+    if (SLANG_FAILED(Path::getPathType(directory, &pathType)))
+    {
+        if (!Path::createDirectory(directory))
+        {
+            return SLANG_FAIL;
+        }
+    }
+    else if (pathType != SLANG_PATH_TYPE_DIRECTORY)
+    {
+        return SLANG_FAIL;
+    }
+
+    RefPtr<DownstreamCompileCache> cache = new DownstreamCompileCache(directory, maxSizeInBytes ? maxSizeInBytes : uint64_t(kDefaultMaxSizeInBytes));
+    cache->m_sizeInBytes = cache->calcSizeInBytes();
+
+    outCache = cache;
+    return SLANG_OK;
+}
+
+String DownstreamCompileCache::_getEntryPath(const String& key)
+{
+    // Two different 64 bit hashes, to make collisions very unlikely. A collision is still handled
+    // correctly, because the entry holds the full key.
+    const HashCode64 hash0 = getStableHashCode64(key.getBuffer(), size_t(key.getLength()));
+
+    // FNV-1a
+    HashCode64 hash1 = 0xcbf29ce484222325ull;
+    for (const char c : key)
+    {
+        hash1 = (hash1 ^ HashCode64(uint8_t(c))) * 0x100000001b3ull;
+    }
+
+    char name[64];
+    ::sprintf(name, "%016llx%016llx", (unsigned long long)hash0, (unsigned long long)hash1);
+
+    StringBuilder builder;
+    builder << name << kEntryExtension;
+    return Path::combine(m_directory, builder);
+}
+
+SlangResult DownstreamCompileCache::find(const String& key, DownstreamDiagnostics& outDiagnostics, ComPtr<ISlangBlob>& outBlob)
+{
+    const String path = _getEntryPath(key);
+
+    List<uint8_t> data;
+    SlangResult res = _readFile(path, data);
+
+    ComPtr<ISlangBlob> blob;
+    DownstreamDiagnostics diagnostics;
+
+    if (SLANG_SUCCEEDED(res))
+    {
+        res = SLANG_E_NOT_FOUND;
+
+        EntryReader reader(data.getBuffer(), size_t(data.getCount()));
+
+        uint32_t magic = 0, version = 0;
+        String readKey;
+        if (SLANG_SUCCEEDED(reader.read(magic)) && magic == kEntryMagic &&
+            SLANG_SUCCEEDED(reader.read(version)) && version == kEntryVersion &&
+            SLANG_SUCCEEDED(reader.readString(readKey)) && readKey.getUnownedSlice() == key.getUnownedSlice())
+        {
+            res = [&]() -> SlangResult
+            {
+                uint32_t diagnosticCount;
+                SLANG_RETURN_ON_FAIL(reader.read(diagnosticCount));
+                for (uint32_t i = 0; i < diagnosticCount; ++i)
+                {
+                    uint32_t type, stage;
+                    int64_t fileLine;
+
+                    DownstreamDiagnostic diagnostic;
+                    SLANG_RETURN_ON_FAIL(reader.read(type));
+                    SLANG_RETURN_ON_FAIL(reader.read(stage));
+                    SLANG_RETURN_ON_FAIL(reader.read(fileLine));
+                    SLANG_RETURN_ON_FAIL(reader.readString(diagnostic.text));
+                    SLANG_RETURN_ON_FAIL(reader.readString(diagnostic.code));
+                    SLANG_RETURN_ON_FAIL(reader.readString(diagnostic.filePath));
+
+                    if (type >= uint32_t(DownstreamDiagnostic::Type::CountOf) || stage > uint32_t(DownstreamDiagnostic::Stage::Link))
+                    {
+                        return SLANG_FAIL;
+                    }
+                    diagnostic.type = DownstreamDiagnostic::Type(type);
+                    diagnostic.stage = DownstreamDiagnostic::Stage(stage);
+                    diagnostic.fileLine = Int(fileLine);
+
+                    diagnostics.diagnostics.add(diagnostic);
+                }
+                SLANG_RETURN_ON_FAIL(reader.readString(diagnostics.rawDiagnostics));
+                SLANG_RETURN_ON_FAIL(reader.read(diagnostics.result));
+
+                const uint8_t* blobData;
+                size_t blobSize;
+                SLANG_RETURN_ON_FAIL(reader.readBytes(blobData, blobSize));
+                blob = createRawBlob(blobData, blobSize);
+                return SLANG_OK;
+            }();
+        }
+
+        if (SLANG_SUCCEEDED(res))
+        {
+            // Mark as recently used
+            File::touch(path);
+        }
+        else
+        {
+            // The entry is for a different key (or is corrupt). It will be replaced when the result is added.
+            res = SLANG_E_NOT_FOUND;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (SLANG_SUCCEEDED(res))
+        {
+            m_stats.hitCount++;
+        }
+        else
+        {
+            m_stats.missCount++;
+        }
+    }
+
+    if (SLANG_SUCCEEDED(res))
+    {
+        outDiagnostics = diagnostics;
+        outBlob = blob;
+    }
+    return res;
+}
+
+SlangResult DownstreamCompileCache::add(const String& key, const DownstreamDiagnostics& diagnostics, ISlangBlob* blob)
+{
+    EntryWriter writer;
+    writer.write(kEntryMagic);
+    writer.write(kEntryVersion);
+    writer.writeString(key);
+
+    writer.write(uint32_t(diagnostics.diagnostics.getCount()));
+    for (const auto& diagnostic : diagnostics.diagnostics)
+    {
+        writer.write(uint32_t(diagnostic.type));
+        writer.write(uint32_t(diagnostic.stage));
+        writer.write(int64_t(diagnostic.fileLine));
+        writer.writeString(diagnostic.text);
+        writer.writeString(diagnostic.code);
+        writer.writeString(diagnostic.filePath);
+    }
+    writer.writeString(diagnostics.rawDiagnostics);
+    writer.write(diagnostics.result);
+
+    if (blob)
+    {
+        writer.writeBytes(blob->getBufferPointer(), blob->getBufferSize());
+    }
+    else
+    {
+        writer.writeBytes(nullptr, 0);
+    }
+
+    const String path = _getEntryPath(key);
+
+    // Write to a uniquely named temporary file, and then rename, so that a reader never sees a partially written entry
+    StringBuilder tempPath;
+    {
+        uint64_t counter;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            counter = m_tempFileCounter++;
+        }
+        const uint64_t time = uint64_t(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        const uint64_t threadHash = uint64_t(std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+        char suffix[80];
+        ::sprintf(suffix, ".%llx-%llx-%llx.tmp", (unsigned long long)time, (unsigned long long)threadHash, (unsigned long long)counter);
+        tempPath << path << suffix;
+    }
+
+    SLANG_RETURN_ON_FAIL(File::writeAllBytes(tempPath, writer.m_data.getBuffer(), size_t(writer.m_data.getCount())));
+    if (SLANG_FAILED(File::rename(tempPath, path)))
+    {
+        File::remove(tempPath);
+        return SLANG_FAIL;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.addCount++;
+        m_sizeInBytes += uint64_t(writer.m_data.getCount());
+
+        if (m_sizeInBytes > m_maxSizeInBytes)
+        {
+            _evict(path);
+        }
+    }
+    return SLANG_OK;
+}
+
+SlangResult DownstreamCompileCache::_findEntries(List<Entry>& outEntries)
+{
+    outEntries.clear();
+
+    EntryVisitor visitor;
+    SLANG_RETURN_ON_FAIL(Path::find(m_directory, nullptr, &visitor));
+
+    for (const auto& filename : visitor.m_filenames)
+    {
+        Entry entry;
+        entry.path = Path::combine(m_directory, filename);
+        // The entry may have been removed since the directory was read
+        if (SLANG_SUCCEEDED(File::getSizeAndModificationTime(entry.path, entry.size, entry.modificationTime)))
+        {
+            outEntries.add(entry);
+        }
+    }
+    return SLANG_OK;
+}
+
+void DownstreamCompileCache::_evict(const String& keepPath)
+{
+    List<Entry> entries;
+    if (SLANG_FAILED(_findEntries(entries)))
+    {
+        return;
+    }
+
+    uint64_t size = 0;
+    for (const auto& entry : entries)
+    {
+        size += entry.size;
+    }
+
+    // Remove down to a 'low water mark' below the cap, so that every add doesn't have to rescan the directory
+    const uint64_t targetSize = m_maxSizeInBytes - m_maxSizeInBytes / 8;
+
+    if (size > m_maxSizeInBytes)
+    {
+        // Oldest first. The modification time only has a resolution of seconds, so order by path
+        // when they are the same, so the order is at least deterministic.
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) -> bool
+        {
+            return a.modificationTime < b.modificationTime || (a.modificationTime == b.modificationTime && a.path < b.path);
+        });
+
+        for (const auto& entry : entries)
+        {
+            if (size <= targetSize)
+            {
+                break;
+            }
+            // The modification time may not distinguish the entry just added from older ones, so it's explicitly kept
+            if (entry.path != keepPath && SLANG_SUCCEEDED(File::remove(entry.path)))
+            {
+                size -= entry.size;
+                m_stats.evictionCount++;
+            }
+        }
+    }
+
+    m_sizeInBytes = size;
+}
+
+DownstreamCompileCache::Stats DownstreamCompileCache::getStats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+uint64_t DownstreamCompileCache::calcSizeInBytes()
+{
+    List<Entry> entries;
+    _findEntries(entries);
+
+    uint64_t size = 0;
+    for (const auto& entry : entries)
+    {
+        size += entry.size;
+    }
+    return size;
+}
+
+SlangResult DownstreamCompileCache::clear()
+{
+    List<Entry> entries;
+    SLANG_RETURN_ON_FAIL(_findEntries(entries));
+
+    SlangResult res = SLANG_OK;
+    for (const auto& entry : entries)
+    {
+        if (SLANG_FAILED(File::remove(entry.path)))
+        {
+            res = SLANG_FAIL;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sizeInBytes = 0;
+    return res;
+}
+
+}
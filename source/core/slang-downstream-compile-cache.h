@@ -0,0 +1,92 @@
+#ifndef SLANG_DOWNSTREAM_COMPILE_CACHE_H
+#define SLANG_DOWNSTREAM_COMPILE_CACHE_H
+
+#include "slang-downstream-compiler.h"
+
+#include <mutex>
+
+namespace Slang
+{
+
+/* A persistent cache of the results of downstream compilations, stored as files in a directory.
+
+An entry is looked up by a 'key' - a string that holds everything that can change the output of a downstream
+compilation (the compiler and its version, the options, the source and so on). The file an entry is stored in
+is named from a hash of the key, and the entry holds the complete key, so a hash collision is just a miss.
+
+The total size of the entries is capped. When an add takes the total over the cap, the least recently used
+entries are removed. Use is tracked via the file modification time, which is updated on every hit.
+
+Entries are written to a temporary file and then renamed into place, so the directory can be shared between
+compilations running on multiple threads or processes. */
+class DownstreamCompileCache : public RefObject
+{
+public:
+    typedef RefObject Super;
+
+    struct Stats
+    {
+        Index hitCount = 0;                 ///< Amount of finds that returned an entry
+        Index missCount = 0;                ///< Amount of finds that didn't find an entry
+        Index addCount = 0;                 ///< Amount of entries written
+        Index evictionCount = 0;            ///< Amount of entries removed to keep under the size cap
+    };
+
+    enum : uint64_t
+    {
+        kDefaultMaxSizeInBytes = uint64_t(256) * 1024 * 1024,
+    };
+
+        /// Find the entry for the key. Returns SLANG_E_NOT_FOUND if there isn't one.
+    SlangResult find(const String& key, DownstreamDiagnostics& outDiagnostics, ComPtr<ISlangBlob>& outBlob);
+        /// Add (or replace) the entry for the key
+    SlangResult add(const String& key, const DownstreamDiagnostics& diagnostics, ISlangBlob* blob);
+
+        /// Get the statistics since the cache was created
+    Stats getStats();
+        /// Get the total size in bytes of the entries in the directory
+    uint64_t calcSizeInBytes();
+
+        /// Remove all the entries
+    SlangResult clear();
+
+    const String& getDirectory() const { return m_directory; }
+    uint64_t getMaxSizeInBytes() const { return m_maxSizeInBytes; }
+
+        /// Append to out a key that identifies the compiler and everything in options that can change the output
+    static void appendKey(const DownstreamCompiler::Desc& desc, const DownstreamCompiler::CompileOptions& options, StringBuilder& out);
+
+        /// Create a cache that uses the directory, which is created if it doesn't exist.
+        /// If maxSizeInBytes is 0 kDefaultMaxSizeInBytes is used.
+    static SlangResult create(const String& directory, uint64_t maxSizeInBytes, RefPtr<DownstreamCompileCache>& outCache);
+
+protected:
+    struct Entry
+    {
+        String path;
+        uint64_t size;
+        int64_t modificationTime;
+    };
+
+    DownstreamCompileCache(const String& directory, uint64_t maxSizeInBytes):
+        m_directory(directory),
+        m_maxSizeInBytes(maxSizeInBytes)
+    {}
+
+    String _getEntryPath(const String& key);
+    SlangResult _findEntries(List<Entry>& outEntries);
+        /// Remove the least recently used entries (other than keepPath) until the total size is below the cap. Must hold m_mutex.
+    void _evict(const String& keepPath);
+
+    String m_directory;
+    uint64_t m_maxSizeInBytes;
+
+    std::mutex m_mutex;                 ///< Guards all of the state below
+    Stats m_stats;
+    uint64_t m_sizeInBytes = 0;         ///< Estimate of the total size of the entries. Recalculated on eviction.
+    uint64_t m_tempFileCounter = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,511 @@
+#ifndef SLANG_CORE_FLAT_DICTIONARY_H
+#define SLANG_CORE_FLAT_DICTIONARY_H
+
+#include "slang-dictionary.h"
+
+#include <string.h>
+
+#if SLANG_PROCESSOR_FAMILY_X86 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#   define SLANG_FLAT_DICTIONARY_SSE2 1
+#   include <emmintrin.h>
+#else
+#   define SLANG_FLAT_DICTIONARY_SSE2 0
+#endif
+
+#if SLANG_VC
+#   include <intrin.h>
+#endif
+
+namespace Slang
+{
+
+/* Helpers for probing a group of control bytes in a FlatDictionary.
+
+Each slot in a FlatDictionary has a control byte. The control byte is kEmpty, kDeleted or, if the slot is
+in use, 7 bits of the hash of its key (so is never negative). A group is kWidth consecutive control bytes,
+which can be matched against a value in one go - with SSE2 if it's available. A match produces a
+mask with a bit set for each matching byte in the group. */
+struct FlatDictionaryGroup
+{
+    typedef uint32_t Mask;
+
+    enum : int8_t
+    {
+        kEmpty = -128,
+        kDeleted = -2,
+    };
+
+    enum
+    {
+        kWidth = 16,
+    };
+
+#if SLANG_FLAT_DICTIONARY_SSE2
+        /// Returns a mask of the bytes in the group starting at ctrl that are equal to h2
+    SLANG_FORCE_INLINE static Mask match(const int8_t* ctrl, int8_t h2)
+    {
+        const __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+        return Mask(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), group)));
+    }
+        /// Returns a mask of the bytes in the group that are kEmpty
+    SLANG_FORCE_INLINE static Mask matchEmpty(const int8_t* ctrl)
+    {
+        return match(ctrl, kEmpty);
+    }
+        /// Returns a mask of the bytes in the group that are kEmpty or kDeleted (they are the only negative values)
+    SLANG_FORCE_INLINE static Mask matchEmptyOrDeleted(const int8_t* ctrl)
+    {
+        return Mask(_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl)));
+    }
+#else
+    SLANG_FORCE_INLINE static Mask match(const int8_t* ctrl, int8_t h2)
+    {
+        Mask mask = 0;
+        for (int i = 0; i < kWidth; ++i)
+        {
+            mask |= Mask(ctrl[i] == h2) << i;
+        }
+        return mask;
+    }
+    SLANG_FORCE_INLINE static Mask matchEmpty(const int8_t* ctrl)
+    {
+        return match(ctrl, kEmpty);
+    }
+    SLANG_FORCE_INLINE static Mask matchEmptyOrDeleted(const int8_t* ctrl)
+    {
+        Mask mask = 0;
+        for (int i = 0; i < kWidth; ++i)
+        {
+            mask |= Mask(ctrl[i] < 0) << i;
+        }
+        return mask;
+    }
+#endif
+
+        /// Returns the index of the lowest set bit. mask must not be 0.
+    SLANG_FORCE_INLINE static int getLowestIndex(Mask mask)
+    {
+        SLANG_ASSERT(mask);
+#if SLANG_VC
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return int(index);
+#elif SLANG_GCC_FAMILY
+        return __builtin_ctz(mask);
+#else
+        int index = 0;
+        while ((mask & 1) == 0)
+        {
+            mask >>= 1;
+            index++;
+        }
+        return index;
+#endif
+    }
+};
+
+/* A hash map with the same interface as Dictionary, implemented as an open addressing table in the style
+of a 'swiss table'.
+
+A lookup first matches the 7 bits of the hash stored in the control bytes a group at a time, and only compares
+keys for the (typically zero or one) slots that match. Probing is quadratic in whole groups, and stops at the
+first group with an empty slot. Keeping the control bytes separate from the slots means the whole probe
+usually touches one cache line of control bytes, and one slot.
+
+The iteration order is not the same as Dictionary, so code that produces output by iterating over a
+map should be careful about switching between them. */
+template<typename TKey, typename TValue>
+class FlatDictionary
+{
+public:
+    typedef FlatDictionary ThisType;
+    typedef FlatDictionaryGroup Group;
+    typedef KeyValuePair<TKey, TValue> Pair;
+
+    class Iterator
+    {
+    public:
+        Pair& operator*() const { return m_dict->m_slots[m_pos]; }
+        Pair* operator->() const { return m_dict->m_slots + m_pos; }
+        Iterator& operator++()
+        {
+            m_pos = m_dict->_findUsed(m_pos + 1);
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator rs = *this;
+            operator++();
+            return rs;
+        }
+        bool operator!=(const Iterator& rhs) const { return m_pos != rhs.m_pos || m_dict != rhs.m_dict; }
+        bool operator==(const Iterator& rhs) const { return m_pos == rhs.m_pos && m_dict == rhs.m_dict; }
+
+        Iterator(const ThisType* dict, Index pos) : m_dict(dict), m_pos(pos) {}
+        Iterator() : m_dict(nullptr), m_pos(0) {}
+
+    protected:
+        const ThisType* m_dict;
+        Index m_pos;
+    };
+
+    class ItemProxy
+    {
+    public:
+        TValue& GetValue() const
+        {
+            TValue* value = m_dict->TryGetValue(m_key);
+            if (!value)
+            {
+                throw KeyNotFoundException("The key does not exists in dictionary.");
+            }
+            return *value;
+        }
+        TValue& operator()() const { return GetValue(); }
+        operator TValue&() const { return GetValue(); }
+
+        TValue& operator=(const TValue& value) const { return const_cast<ThisType*>(m_dict)->Set(Pair(_Move(m_key), value)); }
+        TValue& operator=(TValue&& value) const { return const_cast<ThisType*>(m_dict)->Set(Pair(_Move(m_key), _Move(value))); }
+
+        ItemProxy(const TKey& key, const ThisType* dict) : m_dict(dict), m_key(key) {}
+        ItemProxy(TKey&& key, const ThisType* dict) : m_dict(dict), m_key(_Move(key)) {}
+
+    private:
+        const ThisType* m_dict;
+        TKey m_key;
+    };
+
+    Iterator begin() const { return Iterator(this, _findUsed(0)); }
+    Iterator end() const { return Iterator(this, m_capacity); }
+
+    void Add(const TKey& key, const TValue& value) { Add(Pair(key, value)); }
+    void Add(TKey&& key, TValue&& value) { Add(Pair(_Move(key), _Move(value))); }
+    void Add(Pair&& pair)
+    {
+        if (!AddIfNotExists(_Move(pair)))
+        {
+            throw KeyExistsException("The key already exists in Dictionary.");
+        }
+    }
+
+    bool AddIfNotExists(const TKey& key, const TValue& value) { return AddIfNotExists(Pair(key, value)); }
+    bool AddIfNotExists(TKey&& key, TValue&& value) { return AddIfNotExists(Pair(_Move(key), _Move(value))); }
+    bool AddIfNotExists(Pair&& pair)
+    {
+        bool isNew;
+        const Index index = _findOrInsert(pair.Key, isNew);
+        if (isNew)
+        {
+            m_slots[index] = _Move(pair);
+        }
+        return isNew;
+    }
+
+        /// Set the key to the value, replacing any previous value. Returns the value in the dictionary.
+    TValue& Set(Pair&& pair)
+    {
+        bool isNew;
+        const Index index = _findOrInsert(pair.Key, isNew);
+        m_slots[index] = _Move(pair);
+        return m_slots[index].Value;
+    }
+
+        /// If the key is present returns its value, else adds the key with value and returns nullptr
+    TValue* TryGetValueOrAdd(const TKey& key, const TValue& value)
+    {
+        bool isNew;
+        const Index index = _findOrInsert(key, isNew);
+        if (!isNew)
+        {
+            return &m_slots[index].Value;
+        }
+        m_slots[index] = Pair(key, value);
+        return nullptr;
+    }
+
+    void Remove(const TKey& key)
+    {
+        if (m_count == 0)
+        {
+            return;
+        }
+        const Index index = _find(key, _calcHash(key));
+        if (index >= 0)
+        {
+            _setCtrl(index, Group::kDeleted);
+            // Release anything held by the key and value
+            m_slots[index] = Pair();
+            m_count--;
+        }
+    }
+
+    void Clear()
+    {
+        if (m_count)
+        {
+            for (Index i = _findUsed(0); i < m_capacity; i = _findUsed(i + 1))
+            {
+                m_slots[i] = Pair();
+            }
+        }
+        if (m_capacity)
+        {
+            ::memset(m_ctrl, Group::kEmpty, size_t(m_capacity + Group::kWidth));
+            m_growthLeft = _calcMaxCount(m_capacity);
+        }
+        m_count = 0;
+    }
+
+    bool ContainsKey(const TKey& key) const { return m_count && _find(key, _calcHash(key)) >= 0; }
+
+    bool TryGetValue(const TKey& key, TValue& outValue) const
+    {
+        if (TValue* value = TryGetValue(key))
+        {
+            outValue = *value;
+            return true;
+        }
+        return false;
+    }
+    TValue* TryGetValue(const TKey& key) const
+    {
+        if (m_count == 0)
+        {
+            return nullptr;
+        }
+        const Index index = _find(key, _calcHash(key));
+        return (index >= 0) ? &m_slots[index].Value : nullptr;
+    }
+
+    ItemProxy operator[](const TKey& key) const { return ItemProxy(key, this); }
+    ItemProxy operator[](TKey&& key) const { return ItemProxy(_Move(key), this); }
+
+    int Count() const { return int(m_count); }
+
+        /// Make space for at least count entries without needing to grow
+    void reserve(Index count)
+    {
+        Index capacity = Group::kWidth;
+        while (_calcMaxCount(capacity) < count)
+        {
+            capacity += capacity;
+        }
+        if (capacity > m_capacity)
+        {
+            _resize(capacity);
+        }
+    }
+
+    FlatDictionary() {}
+    FlatDictionary(const ThisType& rhs) { *this = rhs; }
+    FlatDictionary(ThisType&& rhs) { *this = _Move(rhs); }
+    ~FlatDictionary() { _free(); }
+
+    ThisType& operator=(const ThisType& rhs)
+    {
+        if (this != &rhs)
+        {
+            _free();
+            if (rhs.m_capacity)
+            {
+                m_ctrl = new int8_t[rhs.m_capacity + Group::kWidth];
+                ::memcpy(m_ctrl, rhs.m_ctrl, size_t(rhs.m_capacity + Group::kWidth));
+                m_slots = new Pair[rhs.m_capacity];
+                for (Index i = rhs._findUsed(0); i < rhs.m_capacity; i = rhs._findUsed(i + 1))
+                {
+                    m_slots[i] = rhs.m_slots[i];
+                }
+            }
+            m_capacity = rhs.m_capacity;
+            m_count = rhs.m_count;
+            m_growthLeft = rhs.m_growthLeft;
+        }
+        return *this;
+    }
+    ThisType& operator=(ThisType&& rhs)
+    {
+        if (this != &rhs)
+        {
+            _free();
+            m_ctrl = rhs.m_ctrl;
+            m_slots = rhs.m_slots;
+            m_capacity = rhs.m_capacity;
+            m_count = rhs.m_count;
+            m_growthLeft = rhs.m_growthLeft;
+
+            rhs.m_ctrl = nullptr;
+            rhs.m_slots = nullptr;
+            rhs.m_capacity = 0;
+            rhs.m_count = 0;
+            rhs.m_growthLeft = 0;
+        }
+        return *this;
+    }
+
+protected:
+        /// The maximum amount of used and deleted slots for a capacity (a load factor of 7/8)
+    static Index _calcMaxCount(Index capacity) { return capacity - (capacity >> 3); }
+
+    static uint64_t _calcHash(const TKey& key)
+    {
+        // As with Dictionary, the cast is needed because some keys getHashCode are not const.
+        // Mix the bits, as the hash of a pointer for example has the low bits zero.
+        uint64_t hash = uint64_t(getHashCode(const_cast<TKey&>(key))) * 0x9e3779b97f4a7c15ull;
+        return hash ^ (hash >> 32);
+    }
+        /// The 7 bits stored in the control byte
+    static int8_t _getH2(uint64_t hash) { return int8_t(hash & 0x7f); }
+        /// The bits used to find the first group to probe
+    static Index _getH1(uint64_t hash) { return Index(hash >> 7); }
+
+    void _setCtrl(Index index, int8_t ctrl)
+    {
+        m_ctrl[index] = ctrl;
+        // The first group is repeated after the end, so a group can be loaded from any slot without wrapping
+        if (index < Group::kWidth)
+        {
+            m_ctrl[m_capacity + index] = ctrl;
+        }
+    }
+
+        /// Returns the index of the first used slot at or after index, or m_capacity if there isn't one
+    Index _findUsed(Index index) const
+    {
+        while (index < m_capacity && m_ctrl[index] < 0)
+        {
+            index++;
+        }
+        return index;
+    }
+
+        /// Returns the slot index of key, or -1 if not found. Must have m_capacity > 0.
+    Index _find(const TKey& key, uint64_t hash) const
+    {
+        const int8_t h2 = _getH2(hash);
+        const Index mask = m_capacity - 1;
+        Index pos = _getH1(hash) & mask;
+        Index step = 0;
+        for (;;)
+        {
+            const int8_t* ctrl = m_ctrl + pos;
+            for (Group::Mask match = Group::match(ctrl, h2); match; match &= match - 1)
+            {
+                const Index index = (pos + Group::getLowestIndex(match)) & mask;
+                if (m_slots[index].Key == key)
+                {
+                    return index;
+                }
+            }
+            if (Group::matchEmpty(ctrl))
+            {
+                return -1;
+            }
+            // Because the capacity is a power of 2 multiple of kWidth, this visits every group
+            step += Group::kWidth;
+            pos = (pos + step) & mask;
+        }
+    }
+
+        /// Returns the index of the first empty or deleted slot on the probe sequence for hash
+    Index _findInsertIndex(uint64_t hash) const
+    {
+        const Index mask = m_capacity - 1;
+        Index pos = _getH1(hash) & mask;
+        Index step = 0;
+        for (;;)
+        {
+            if (const Group::Mask match = Group::matchEmptyOrDeleted(m_ctrl + pos))
+            {
+                return (pos + Group::getLowestIndex(match)) & mask;
+            }
+            step += Group::kWidth;
+            pos = (pos + step) & mask;
+        }
+    }
+
+        /// Returns the slot index for key. If the key isn't found the slot is marked as used, the count
+        /// updated, and isNew set - the caller must then set the slot.
+    Index _findOrInsert(const TKey& key, bool& outIsNew)
+    {
+        const uint64_t hash = _calcHash(key);
+        if (m_count)
+        {
+            const Index index = _find(key, hash);
+            if (index >= 0)
+            {
+                outIsNew = false;
+                return index;
+            }
+        }
+
+        if (m_growthLeft == 0)
+        {
+            // If deleted slots take up a lot of the table, just rehash at the same size to remove them
+            _resize((m_capacity == 0) ? Index(Group::kWidth) :
+                (m_count * 2 > _calcMaxCount(m_capacity)) ? m_capacity * 2 : m_capacity);
+        }
+
+        const Index index = _findInsertIndex(hash);
+        // Reusing a deleted slot doesn't reduce how many more can be added
+        if (m_ctrl[index] == Group::kEmpty)
+        {
+            m_growthLeft--;
+        }
+        _setCtrl(index, _getH2(hash));
+        m_count++;
+
+        outIsNew = true;
+        return index;
+    }
+
+    void _resize(Index capacity)
+    {
+        SLANG_ASSERT(capacity >= Group::kWidth && (capacity & (capacity - 1)) == 0);
+
+        int8_t* oldCtrl = m_ctrl;
+        Pair* oldSlots = m_slots;
+        const Index oldCapacity = m_capacity;
+
+        m_ctrl = new int8_t[capacity + Group::kWidth];
+        ::memset(m_ctrl, Group::kEmpty, size_t(capacity + Group::kWidth));
+        m_slots = new Pair[capacity];
+        m_capacity = capacity;
+
+        for (Index i = 0; i < oldCapacity; ++i)
+        {
+            if (oldCtrl[i] >= 0)
+            {
+                const uint64_t hash = _calcHash(oldSlots[i].Key);
+                const Index index = _findInsertIndex(hash);
+                _setCtrl(index, _getH2(hash));
+                m_slots[index] = _Move(oldSlots[i]);
+            }
+        }
+        m_growthLeft = _calcMaxCount(capacity) - m_count;
+
+        delete[] oldCtrl;
+        delete[] oldSlots;
+    }
+
+    void _free()
+    {
+        delete[] m_ctrl;
+        delete[] m_slots;
+        m_ctrl = nullptr;
+        m_slots = nullptr;
+    }
+
+    int8_t* m_ctrl = nullptr;           ///< Control byte for each slot, followed by a copy of the first group
+    Pair* m_slots = nullptr;
+    Index m_capacity = 0;               ///< 0 or a power of 2 >= Group::kWidth
+    Index m_count = 0;
+    Index m_growthLeft = 0;             ///< How many empty slots can be used before the table must be rehashed
+};
+
+template <typename T>
+class FlatHashSet : public HashSetBase<T, FlatDictionary<T, _DummyClass>>
+{};
+
+}
+
+#endif
@@ -11,6 +11,7 @@
 
 #ifdef _WIN32
 #   include <direct.h>
+#   include <sys/utime.h>
 
 #   define WIN32_LEAN_AND_MEAN
 #   define VC_EXTRALEAN
@@ -19,6 +20,7 @@
 
 #if defined(__linux__) || defined(__CYGWIN__) || SLANG_APPLE_FAMILY
 #   include <unistd.h>
+#   include <utime.h>
 // For Path::find
 #   include <fnmatch.h>
 
@@ -149,6 +151,51 @@ namespace Slang
     }
 
 
+    /* static */SlangResult File::getSizeAndModificationTime(const String& fileName, uint64_t& outSize, int64_t& outModificationTime)
+    {
+#ifdef _WIN32
+        struct _stat64 statVar;
+        if (::_wstat64(fileName.toWString(), &statVar) != 0)
+        {
+            return SLANG_E_NOT_FOUND;
+        }
+#else
+        struct stat statVar;
+        if (::stat(fileName.getBuffer(), &statVar) != 0)
+        {
+            return SLANG_E_NOT_FOUND;
+        }
+#endif
+        outSize = uint64_t(statVar.st_size);
+        outModificationTime = int64_t(statVar.st_mtime);
+        return SLANG_OK;
+    }
+
+    /* static */SlangResult File::touch(const String& fileName)
+    {
+        // Passing nullptr sets the access and modification times to the current time
+#ifdef _WIN32
+        return ::_wutime(fileName.toWString(), nullptr) == 0 ? SLANG_OK : SLANG_FAIL;
+#else
+        return ::utime(fileName.getBuffer(), nullptr) == 0 ? SLANG_OK : SLANG_FAIL;
+#endif
+    }
+
+    /* static */SlangResult File::rename(const String& fromFileName, const String& toFileName)
+    {
+#ifdef _WIN32
+        // https://docs.microsoft.com/en-us/windows/win32/api/winbase/nf-winbase-movefileexa
+        if (::MoveFileExA(fromFileName.getBuffer(), toFileName.getBuffer(), MOVEFILE_REPLACE_EXISTING))
+        {
+            return SLANG_OK;
+        }
+        return SLANG_FAIL;
+#else
+        // https://linux.die.net/man/3/rename
+        return ::rename(fromFileName.getBuffer(), toFileName.getBuffer()) == 0 ? SLANG_OK : SLANG_FAIL;
+#endif
+    }
+
     bool File::exists(const String& fileName)
     {
 #ifdef _WIN32
@@ -795,6 +842,20 @@ namespace Slang
         writer.Write(text);
     }
 
+    SlangResult File::writeAllBytes(const Slang::String& fileName, const void* data, size_t size)
+    {
+        try
+        {
+            RefPtr<FileStream> fs = new FileStream(fileName, FileMode::Create, FileAccess::Write, FileShare::ReadWrite);
+            fs->write(data, size);
+        }
+        catch (const IOException&)
+        {
+            return SLANG_FAIL;
+        }
+        return SLANG_OK;
+    }
+
 
 }
 
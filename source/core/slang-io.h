@@ -15,10 +15,18 @@ namespace Slang
 		static String readAllText(const String& fileName);
 		static List<unsigned char> readAllBytes(const String& fileName);
 		static void writeAllText(const String& fileName, const String& text);
+        static SlangResult writeAllBytes(const String& fileName, const void* data, size_t size);
         static SlangResult remove(const String& fileName);
 
         static SlangResult makeExecutable(const String& fileName);
 
+            /// Get the size (in bytes) of a file, and the time it was last modified (in seconds since the epoch)
+        static SlangResult getSizeAndModificationTime(const String& fileName, uint64_t& outSize, int64_t& outModificationTime);
+            /// Set the modification time of a file to the current time
+        static SlangResult touch(const String& fileName);
+            /// Rename (or move) a file. If a file already exists at `toFileName` it is replaced.
+        static SlangResult rename(const String& fromFileName, const String& toFileName);
+
         static SlangResult generateTemporary(const UnownedStringSlice& prefix, String& outFileName);
 	};
 
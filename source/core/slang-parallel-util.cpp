@@ -0,0 +1,66 @@
+// slang-parallel-util.cpp
+#include "slang-parallel-util.h"
+
+#include "slang-list.h"
+
+#include <atomic>
+#include <thread>
+
+namespace Slang
+{
+
+/* static */Index ParallelUtil::getHardwareThreadCount()
+{
+    const Index count = Index(std::thread::hardware_concurrency());
+    return count > 0 ? count : 1;
+}
+
+/* static */void ParallelUtil::forEach(Index count, Index threadCount, const std::function<void(Index)>& func)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = getHardwareThreadCount();
+    }
+    // There is no point having more threads than there is work
+    threadCount = (threadCount < count) ? threadCount : count;
+
+    if (threadCount <= 1)
+    {
+        for (Index i = 0; i < count; ++i)
+        {
+            func(i);
+        }
+        return;
+    }
+
+    std::atomic<Index> nextIndex(0);
+    auto worker = [&]()
+    {
+        for (;;)
+        {
+            const Index index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+            if (index >= count)
+            {
+                break;
+            }
+            func(index);
+        }
+    };
+
+    // The calling thread does work too, so we only need to start `threadCount - 1` more
+    List<std::thread> threads;
+    threads.setCount(threadCount - 1);
+    for (auto& thread : threads)
+    {
+        thread = std::thread(worker);
+    }
+
+    worker();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+}
@@ -0,0 +1,29 @@
+#ifndef SLANG_PARALLEL_UTIL_H
+#define SLANG_PARALLEL_UTIL_H
+
+#include "slang-common.h"
+
+#include <functional>
+
+namespace Slang
+{
+
+/* Utilities for running independent pieces of work on multiple threads.
+
+Work is identified by an index. Each thread (including the calling thread) repeatedly claims the
+next unclaimed index, so a long running piece of work doesn't hold up the work queued behind it. */
+struct ParallelUtil
+{
+        /// Get the number of threads the hardware can run concurrently. Always at least 1.
+    static Index getHardwareThreadCount();
+
+        /// Call `func(i)` for each `i` in [0, count), using at most `threadCount` threads.
+        /// If `threadCount` is 0, the hardware thread count is used.
+        /// The calls may happen in any order, and `func` must not throw.
+        /// Returns when all of the calls have completed.
+    static void forEach(Index count, Index threadCount, const std::function<void(Index)>& func);
+};
+
+}
+
+#endif
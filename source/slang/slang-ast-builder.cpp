@@ -100,6 +100,15 @@ Type* SharedASTBuilder::getEnumTypeType()
     return m_enumTypeType;
 }
 
+void SharedASTBuilder::freeze()
+{
+    // The string and enum types are created lazily, because their declarations are in the stdlib
+    getStringType();
+    getEnumTypeType();
+
+    m_astBuilder->freeze();
+}
+
 SharedASTBuilder::~SharedASTBuilder()
 {
     // Release built in types..
@@ -167,6 +176,29 @@ ASTBuilder::~ASTBuilder()
     }
 }
 
+void ASTBuilder::freeze()
+{
+    if (m_isFrozen)
+    {
+        return;
+    }
+
+    // Evaluating the lazy state can create new types on this builder (for example a canonical type),
+    // which are appended to m_types, so iterate by index until no more are added.
+    for (Index i = 0; i < m_types.getCount(); ++i)
+    {
+        Type* type = m_types[i];
+        type->getCanonicalType();
+
+        if (auto matrixType = dynamicCast<MatrixExpressionType>(type))
+        {
+            matrixType->getRowType();
+        }
+    }
+
+    m_isFrozen = true;
+}
+
 NodeBase* ASTBuilder::createByNodeType(ASTNodeType nodeType)
 {
     const ReflectClassInfo* info = ReflectClassInfo::getInfo(nodeType);
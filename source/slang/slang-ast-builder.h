@@ -3,6 +3,7 @@
 #define SLANG_AST_BUILDER_H
 
 #include <type_traits>
+#include <atomic>
 
 #include "slang-ast-support-types.h"
 #include "slang-ast-all.h"
@@ -41,6 +42,10 @@ public:
         /// Must be called before used
     void init(Session* session);
 
+        /// Evaluates the lazily created shared types, and freezes the builder holding the shared types.
+        /// Can only be called once the stdlib has been set up.
+    void freeze();
+
     SharedASTBuilder();
 
     ~SharedASTBuilder();
@@ -76,7 +81,8 @@ protected:
     ASTBuilder* m_astBuilder = nullptr;
     Session* m_session = nullptr;
 
-    Index m_id = 1;
+        // Used to give each ASTBuilder a unique id. Atomic as ASTBuilders can be created on multiple threads.
+    std::atomic<Index> m_id{1};
 };
 
 class ASTBuilder : public RefObject
@@ -167,6 +173,13 @@ public:
         /// Get the global session
     Session* getGlobalSession() { return m_sharedASTBuilder->m_session; }
 
+        /// Evaluates all of the lazily computed state (such as canonical types) of the types created on this
+        /// builder, and disallows creating any further nodes. After this the nodes are not modified by being
+        /// used, and so can be used from multiple threads at the same time (as is the case for the stdlib).
+    void freeze();
+        /// True if the builder has been frozen
+    bool isFrozen() const { return m_isFrozen; }
+
         /// Ctor
     ASTBuilder(SharedASTBuilder* sharedASTBuilder, const String& name);
 
@@ -182,7 +195,10 @@ protected:
     {
         SLANG_COMPILE_TIME_ASSERT(IsValidType<T>::Value);
 
+        SLANG_ASSERT(!m_isFrozen);
+
         node->init(T::kType, this);
+        _addType(node);
         // Only add it if it has a dtor that does some work
         if (!std::is_trivially_destructible<T>::value)
         {
@@ -192,9 +208,18 @@ protected:
         return node;
     }
 
+        // Types hold lazily evaluated state, so are tracked such that it can be evaluated on `freeze`
+    SLANG_FORCE_INLINE void _addType(Type* type) { m_types.add(type); }
+    SLANG_FORCE_INLINE void _addType(NodeBase*) {}
+
     String m_name;
     Index m_id;
 
+        /// All of the types created on this builder
+    List<Type*> m_types;
+
+    bool m_isFrozen = false;
+
         /// List of all nodes that require being dtored when ASTBuilder is dtored
     List<NodeBase*> m_dtorNodes;
 
@@ -318,7 +318,7 @@ struct ASTDumpContext
         m_writer->emit("NameLoc{");
         if (nameLoc.name)
         {
-            dump(nameLoc.name->text.getUnownedSlice());
+            dump(nameLoc.name->text);
         }
         else
         {
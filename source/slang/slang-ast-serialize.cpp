@@ -341,9 +341,6 @@ struct ASTSerialTypeInfo<Dictionary<KEY, VALUE>>
         ASTSerialIndex values;          ///< Index an array
     };
 
-    typedef typename ASTSerialTypeInfo<KEY>::SerialType KeySerialType;
-    typedef typename ASTSerialTypeInfo<VALUE>::SerialType ValueSerialType;
-
     enum { SerialAlignment = SLANG_ALIGN_OF(ASTSerialIndex) };
 
     static void toSerial(ASTSerialWriter* writer, const void* native, void* serial)
@@ -351,18 +348,19 @@ struct ASTSerialTypeInfo<Dictionary<KEY, VALUE>>
         auto& src = *(const NativeType*)native;
         auto& dst = *(SerialType*)serial;
 
-        List<KeySerialType> keys;
-        List<ValueSerialType> values;
+        // Gather the native keys and values, and let addArray do the conversion to serial types
+        List<KEY> keys;
+        List<VALUE> values;
 
-        Index count = Index(src.Count());
+        const Index count = Index(src.Count());
         keys.setCount(count);
         values.setCount(count);
 
         Index i = 0;
         for (const auto& pair : src)
         {
-            ASTSerialTypeInfo<KEY>::toSerial(writer, &pair.Key, &keys[i]);
-            ASTSerialTypeInfo<VALUE>::toSerial(writer, &pair.Value, &values[i]);
+            keys[i] = pair.Key;
+            values[i] = pair.Value;
             i++;
         }
 
@@ -480,7 +478,7 @@ struct ASTSerialTypeInfo<LookupResultItem::Breadcrumb>
         NativeType::Kind kind;
         NativeType::ThisParameterMode thisParameterMode;
         ASTSerialTypeInfo<DeclRef<Decl>>::SerialType declRef;
-        ASTSerialTypeInfo<RefPtr<NativeType>> next; 
+        ASTSerialTypeInfo<RefPtr<NativeType>>::SerialType next;
     };
     enum { SerialAlignment = SLANG_ALIGN_OF(SerialType) };
 
@@ -515,7 +513,7 @@ struct ASTSerialTypeInfo<LookupResultItem>
     struct SerialType
     {
         ASTSerialTypeInfo<DeclRef<Decl>>::SerialType declRef;
-        ASTSerialTypeInfo<RefPtr<NativeType::Breadcrumb>> breadcrumbs;
+        ASTSerialTypeInfo<RefPtr<NativeType::Breadcrumb>>::SerialType breadcrumbs;
     };
     enum { SerialAlignment = SLANG_ALIGN_OF(SerialType) };
 
@@ -697,7 +695,7 @@ struct ASTSerialTypeInfo<DeclCheckStateExt>
     static void toNative(ASTSerialReader* reader, const void* serial, void* native)
     {
         SLANG_UNUSED(reader);
-        (*(NativeType*)serial).setRaw(*(const SerialType*)native); 
+        (*(NativeType*)native).setRaw(*(const SerialType*)serial);
     }
 };
 
@@ -732,6 +730,7 @@ struct ASTSerialTypeInfo<Modifiers>
             {
                 prev->next = modifier;
             }
+            prev = modifier;
         }
 
         NativeType& dst = *(NativeType*)native;
@@ -895,6 +894,92 @@ struct ASTSerialTypeInfo<const DiagnosticInfo*>
     }
 };
 
+// RequirementWitness
+template <>
+struct ASTSerialTypeInfo<RequirementWitness>
+{
+    typedef RequirementWitness NativeType;
+    struct SerialType
+    {
+        ASTSerialTypeInfo<DeclRef<Decl>>::SerialType declRef;
+        ASTSerialIndex obj;
+        ASTSerialIndex val;
+        uint8_t flavor;
+    };
+    enum { SerialAlignment = SLANG_ALIGN_OF(ASTSerialIndex) };
+
+    static void toSerial(ASTSerialWriter* writer, const void* native, void* serial)
+    {
+        auto& src = *(const NativeType*)native;
+        auto& dst = *(SerialType*)serial;
+
+        dst.flavor = uint8_t(src.m_flavor);
+        _toSerialValue(writer, src.m_declRef, dst.declRef);
+        dst.obj = writer->addPointer(src.m_obj);
+        dst.val = writer->addPointer(src.m_val);
+    }
+    static void toNative(ASTSerialReader* reader, const void* serial, void* native)
+    {
+        auto& src = *(const SerialType*)serial;
+        auto& dst = *(NativeType*)native;
+
+        dst.m_flavor = NativeType::Flavor(src.flavor);
+        _toNativeValue(reader, src.declRef, dst.m_declRef);
+        dst.m_obj = reader->getPointer(src.obj).dynamicCast<RefObject>();
+        dst.m_val = reader->getPointer(src.val).dynamicCast<Val>();
+    }
+};
+
+// WitnessTable
+template <>
+struct ASTSerialTypeInfo<WitnessTable>
+{
+    typedef WitnessTable NativeType;
+    struct SerialType
+    {
+        ASTSerialTypeInfo<RequirementDictionary>::SerialType requirementDictionary;
+        ASTSerialIndex baseType;
+    };
+    enum { SerialAlignment = SLANG_ALIGN_OF(ASTSerialIndex) };
+
+    static void toSerial(ASTSerialWriter* writer, const void* native, void* serial)
+    {
+        auto& src = *(const NativeType*)native;
+        auto& dst = *(SerialType*)serial;
+
+        _toSerialValue(writer, src.requirementDictionary, dst.requirementDictionary);
+        dst.baseType = writer->addPointer(src.baseType);
+    }
+    static void toNative(ASTSerialReader* reader, const void* serial, void* native)
+    {
+        auto& src = *(const SerialType*)serial;
+        auto& dst = *(NativeType*)native;
+
+        _toNativeValue(reader, src.requirementDictionary, dst.requirementDictionary);
+        dst.baseType = reader->getPointer(src.baseType).dynamicCast<Type>();
+    }
+};
+
+// CandidateExtensionList
+template <>
+struct ASTSerialTypeInfo<CandidateExtensionList>
+{
+    typedef CandidateExtensionList NativeType;
+    typedef ASTSerialIndex SerialType;
+    enum { SerialAlignment = SLANG_ALIGN_OF(SerialType) };
+
+    static void toSerial(ASTSerialWriter* writer, const void* native, void* serial)
+    {
+        auto& src = *(const NativeType*)native;
+        _toSerialValue(writer, src.candidateExtensions, *(SerialType*)serial);
+    }
+    static void toNative(ASTSerialReader* reader, const void* serial, void* native)
+    {
+        auto& dst = *(NativeType*)native;
+        _toNativeValue(reader, *(const SerialType*)serial, dst.candidateExtensions);
+    }
+};
+
 // !!!!!!!!!!!!!!!!!!!!! ASTSerialGetType<T> !!!!!!!!!!!!!!!!!!!!!!!!!!!
 // Getting the type info, let's use a static variable to hold the state to keep simple
 
@@ -1088,6 +1173,28 @@ ASTSerialIndex ASTSerialWriter::addPointer(const NodeBase* node)
     return index;
 }
 
+template <typename T>
+ASTSerialIndex ASTSerialWriter::_addRefObject(const T* obj, ASTSerialInfo::RefObjectEntry::SubType subType)
+{
+    typedef ASTSerialTypeInfo<T> TypeInfo;
+    typedef ASTSerialInfo::RefObjectEntry RefObjectEntry;
+
+    size_t alignment = TypeInfo::SerialAlignment;
+    alignment = (alignment < SLANG_ALIGN_OF(RefObjectEntry)) ? SLANG_ALIGN_OF(RefObjectEntry) : alignment;
+
+    RefObjectEntry* entry = (RefObjectEntry*)m_arena.allocateAligned(sizeof(RefObjectEntry) + sizeof(typename TypeInfo::SerialType), alignment);
+
+    entry->type = ASTSerialInfo::Type::RefObject;
+    entry->info = ASTSerialInfo::makeEntryInfo(int(alignment));
+    entry->subType = subType;
+
+    auto index = _add(obj, entry);
+
+    // Do any conversion
+    TypeInfo::toSerial(this, obj, entry + 1);
+    return index;
+}
+
 ASTSerialIndex ASTSerialWriter::addPointer(const RefObject* obj)
 {
     // Null is always 0
@@ -1110,23 +1217,15 @@ ASTSerialIndex ASTSerialWriter::addPointer(const RefObject* obj)
     }
     else if (auto breadcrumb = dynamicCast<LookupResultItem::Breadcrumb>(obj))
     {
-        typedef ASTSerialTypeInfo<LookupResultItem::Breadcrumb> TypeInfo;
-        typedef ASTSerialInfo::RefObjectEntry RefObjectEntry;
-
-        size_t alignment = TypeInfo::SerialAlignment;
-        alignment = (alignment < SLANG_ALIGN_OF(ASTSerialInfo::RefObjectEntry)) ? SLANG_ALIGN_OF(ASTSerialInfo::RefObjectEntry) : alignment;
-
-        RefObjectEntry* entry = (RefObjectEntry*)m_arena.allocateAligned(sizeof(RefObjectEntry) + sizeof(TypeInfo::SerialType), alignment);
-
-        entry->type = ASTSerialInfo::Type::RefObject;
-        entry->info = ASTSerialInfo::makeEntryInfo(int(alignment));
-        entry->subType = RefObjectEntry::SubType::Breadcrumb;
-
-        auto index = _add(breadcrumb, entry);
-
-        // Do any conversion
-        TypeInfo::toSerial(this, breadcrumb, entry + 1);
-        return index;
+        return _addRefObject(breadcrumb, ASTSerialInfo::RefObjectEntry::SubType::Breadcrumb);
+    }
+    else if (auto witnessTable = dynamicCast<WitnessTable>(obj))
+    {
+        return _addRefObject(witnessTable, ASTSerialInfo::RefObjectEntry::SubType::WitnessTable);
+    }
+    else if (auto candidateExtensionList = dynamicCast<CandidateExtensionList>(obj))
+    {
+        return _addRefObject(candidateExtensionList, ASTSerialInfo::RefObjectEntry::SubType::CandidateExtensionList);
     }
     else if (auto name = dynamicCast<const Name>(obj))
     {
@@ -1358,6 +1457,16 @@ size_t ASTSerialInfo::Entry::calcSize(ASTSerialClasses* serialClasses) const
                     payloadSize = sizeof(ASTSerialTypeInfo<LookupResultItem::Breadcrumb>::SerialType);
                     break;
                 }
+                case RefObjectEntry::SubType::WitnessTable:
+                {
+                    payloadSize = sizeof(ASTSerialTypeInfo<WitnessTable>::SerialType);
+                    break;
+                }
+                case RefObjectEntry::SubType::CandidateExtensionList:
+                {
+                    payloadSize = sizeof(ASTSerialTypeInfo<CandidateExtensionList>::SerialType);
+                    break;
+                }
                 default:
                 {
                     SLANG_ASSERT(!"Unknown type");
@@ -1629,6 +1738,20 @@ SlangResult ASTSerialReader::load(const uint8_t* data, size_t dataCount, ASTBuil
                         m_objects[i] = breadcrumb;
                         break;
                     }
+                    case ASTSerialInfo::RefObjectEntry::SubType::WitnessTable:
+                    {
+                        auto witnessTable = new WitnessTable;
+                        m_scope.add(witnessTable);
+                        m_objects[i] = witnessTable;
+                        break;
+                    }
+                    case ASTSerialInfo::RefObjectEntry::SubType::CandidateExtensionList:
+                    {
+                        auto candidateExtensionList = new CandidateExtensionList;
+                        m_scope.add(candidateExtensionList);
+                        m_objects[i] = candidateExtensionList;
+                        break;
+                    }
                     default:
                     {
                         SLANG_ASSERT(!"Unknown type");
@@ -1694,7 +1817,19 @@ SlangResult ASTSerialReader::load(const uint8_t* data, size_t dataCount, ASTBuil
                     {
                         typedef LookupResultItem::Breadcrumb Breadcrumb;
                         auto serialType = ASTSerialGetType<Breadcrumb>::getType();
-                        serialType->toNativeFunc(this, (entry + 1), m_objects[i]);
+                        serialType->toNativeFunc(this, (objEntry + 1), m_objects[i]);
+                        break;
+                    }
+                    case ASTSerialInfo::RefObjectEntry::SubType::WitnessTable:
+                    {
+                        auto serialType = ASTSerialGetType<WitnessTable>::getType();
+                        serialType->toNativeFunc(this, (objEntry + 1), m_objects[i]);
+                        break;
+                    }
+                    case ASTSerialInfo::RefObjectEntry::SubType::CandidateExtensionList:
+                    {
+                        auto serialType = ASTSerialGetType<CandidateExtensionList>::getType();
+                        serialType->toNativeFunc(this, (objEntry + 1), m_objects[i]);
                         break;
                     }
                     default:
@@ -273,6 +273,8 @@ struct ASTSerialInfo
         enum class SubType : uint8_t
         {
             Breadcrumb,
+            WitnessTable,
+            CandidateExtensionList,
         };
         SubType subType;
         uint8_t _pad0;
@@ -443,6 +445,9 @@ protected:
 
     ASTSerialIndex _addArray(size_t elementSize, size_t alignment, const void* elements, Index elementCount);
 
+    template <typename T>
+    ASTSerialIndex _addRefObject(const T* obj, ASTSerialInfo::RefObjectEntry::SubType subType);
+
     ASTSerialIndex _add(const void* nativePtr, ASTSerialInfo::Entry* entry)
     {
         m_entries.add(entry);
@@ -183,7 +183,7 @@ namespace Slang
             Name* tokenName = token.getNameOrNull();
             if (tokenName)
             {
-                name = tokenName->text.getUnownedSlice();
+                name = tokenName->text;
             }
         }
     };
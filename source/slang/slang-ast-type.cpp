@@ -66,11 +66,16 @@ Type* Type::getCanonicalType()
     Type* et = const_cast<Type*>(this);
     if (!et->canonicalType)
     {
-        // TODO(tfoley): worry about thread safety here?
         auto canType = et->createCanonicalType();
-        et->canonicalType = canType;
+        SLANG_ASSERT(canType);
 
-        SLANG_ASSERT(et->canonicalType);
+        // A canonical type is its own canonical type. Setting this avoids creating
+        // another (equivalent) type if the canonical type is itself canonicalized.
+        if (!canType->canonicalType)
+        {
+            canType->canonicalType = canType;
+        }
+        et->canonicalType = canType;
     }
     return et->canonicalType;
 }
@@ -947,7 +952,7 @@ Val* ThisType::_substituteImplOverride(ASTBuilder* astBuilder, SubstitutionSet s
 
     (*ioDiff)++;
 
-    ThisType* substType = m_astBuilder->create<ThisType>();
+    ThisType* substType = astBuilder->create<ThisType>();
     substType->interfaceDeclRef = substInterfaceDeclRef;
     return substType;
 }
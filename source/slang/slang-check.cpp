@@ -82,6 +82,8 @@ namespace Slang
 
     void Session::setSharedLibraryLoader(ISlangSharedLibraryLoader* loader)
     {
+        std::lock_guard<std::recursive_mutex> lock(m_downstreamCompilerMutex);
+
         if (m_sharedLibraryLoader != loader)
         {
             // Need to clear all of the libraries
@@ -103,6 +105,8 @@ namespace Slang
 
     void Session::resetDownstreamCompiler(PassThroughMode type)
     {
+        std::lock_guard<std::recursive_mutex> lock(m_downstreamCompilerMutex);
+
         // Mark as initialized
         m_downstreamCompilerInitialized &= ~(1 << int(type));
         m_downstreamCompilers[int(type)].setNull();
@@ -110,6 +114,9 @@ namespace Slang
 
     DownstreamCompiler* Session::getOrLoadDownstreamCompiler(PassThroughMode type, DiagnosticSink* sink)
     {
+        // Compilers are loaded lazily, and requests on multiple threads may use the same session
+        std::lock_guard<std::recursive_mutex> lock(m_downstreamCompilerMutex);
+
         if (m_downstreamCompilerInitialized & (1 << int(type)))
         {
             return m_downstreamCompilers[int(type)];
@@ -157,6 +164,8 @@ namespace Slang
 
     SlangFuncPtr Session::getSharedLibraryFunc(SharedLibraryFuncType type, DiagnosticSink* sink)
     {
+        std::lock_guard<std::recursive_mutex> lock(m_downstreamCompilerMutex);
+
         if (m_sharedLibraryFunctions[int(type)])
         {
             return m_sharedLibraryFunctions[int(type)];
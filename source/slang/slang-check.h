@@ -36,4 +36,11 @@ namespace Slang
 
     bool isGlobalShaderParameter(VarDeclBase* decl);
     bool isFromStdLib(Decl* decl);
+
+        /// Register any builtin declarations under `decl` with the `session`.
+        ///
+        /// This is normally done as part of checking standard library code, but needs
+        /// to be performed explicitly when a standard library module is deserialized.
+        ///
+    void registerBuiltinDecls(Session* session, Decl* decl);
 }
@@ -1,10 +1,12 @@
 // Compiler.cpp : Defines the entry point for the console application.
 //
 #include "../core/slang-basic.h"
+#include "../core/slang-blob.h"
 #include "../core/slang-platform.h"
 #include "../core/slang-io.h"
 #include "../core/slang-string-util.h"
 #include "../core/slang-hex-dump-util.h"
+#include "../core/slang-parallel-util.h"
 #include "../core/slang-riff.h"
 #include "../core/slang-type-text-util.h"
 
@@ -24,6 +26,7 @@
 #include "slang-glsl-extension-tracker.h"
 #include "slang-emit-cuda.h"
 
+#include "slang-ir-link.h"
 #include "slang-ir-serialize.h"
 
 // Enable calling through to `fxc` or `dxc` to
@@ -70,6 +73,9 @@
 #include <unistd.h>
 #endif
 
+#include <atomic>
+#include <exception>
+
 #ifdef _MSC_VER
 #pragma warning(disable: 4996)
 #endif
@@ -1250,6 +1256,13 @@ SlangResult dissassembleDXILUsingDXC(
         return SLANG_OK;
     }
 
+        /// Append to out the part of a downstream compile cache key that identifies the version of Slang and the target
+    static void _appendDownstreamCompileCacheKeyPrefix(Session* session, TargetRequest* targetReq, StringBuilder& out)
+    {
+        out << "slang:" << session->getBuildTagString() << "\n";
+        out << "target:" << int(targetReq->target) << " " << UInt32(targetReq->targetProfile.raw) << "\n";
+    }
+
     SlangResult emitWithDownstreamForEntryPoints(
         BackEndCompileRequest*  slangRequest,
         const List<Int>&        entryPointIndices,
@@ -1546,7 +1559,42 @@ SlangResult dissassembleDXILUsingDXC(
 
         // Compile
         RefPtr<DownstreamCompileResult> downstreamCompileResult;
-        SLANG_RETURN_ON_FAIL(compiler->compile(options, downstreamCompileResult));
+
+        // If there is a downstream compile cache, the result may already be in it.
+        // Pass-through compilations aren't cached, because the source may include files that aren't part of the key.
+        // Host callable results aren't cached, because the result is a loaded shared library, not just a binary.
+        DownstreamCompileCache* cache = session->getDownstreamCompileCache();
+        String cacheKey;
+        if (cache && !isPassThroughEnabled(endToEndReq) && targetReq->target != CodeGenTarget::HostCallable)
+        {
+            StringBuilder keyBuilder;
+            _appendDownstreamCompileCacheKeyPrefix(session, targetReq, keyBuilder);
+            DownstreamCompileCache::appendKey(compiler->getDesc(), options, keyBuilder);
+            cacheKey = keyBuilder.ProduceString();
+
+            DownstreamDiagnostics cachedDiagnostics;
+            ComPtr<ISlangBlob> cachedBlob;
+            if (SLANG_SUCCEEDED(cache->find(cacheKey, cachedDiagnostics, cachedBlob)))
+            {
+                downstreamCompileResult = new BlobDownstreamCompileResult(cachedDiagnostics, cachedBlob);
+            }
+        }
+
+        if (!downstreamCompileResult)
+        {
+            SLANG_RETURN_ON_FAIL(compiler->compile(options, downstreamCompileResult));
+
+            // Only successful compilations are cached, so a failure is always reported by the downstream compiler itself
+            if (cacheKey.getLength() && !downstreamCompileResult->getDiagnostics().has(DownstreamDiagnostic::Type::Error))
+            {
+                ComPtr<ISlangBlob> blob;
+                if (SLANG_SUCCEEDED(downstreamCompileResult->getBinary(blob)))
+                {
+                    // Failing to write to the cache doesn't fail the compilation
+                    cache->add(cacheKey, downstreamCompileResult->getDiagnostics(), blob);
+                }
+            }
+        }
         
         const auto& diagnostics = downstreamCompileResult->getDiagnostics();
 
@@ -1668,7 +1716,41 @@ SlangResult dissassembleDXILUsingDXC(
         request.outputFunc = outputFunc;
         request.outputUserData = &spirvOut;
 
+        // If there is a downstream compile cache, the SPIR-V may already be in it.
+        // slang-glslang doesn't report a version, but is built along with Slang, so is identified by the build tag.
+        Session* session = slangRequest->getSession();
+        DownstreamCompileCache* cache = session->getDownstreamCompileCache();
+        String cacheKey;
+        if (cache)
+        {
+            auto linkage = slangRequest->getLinkage();
+
+            StringBuilder keyBuilder;
+            _appendDownstreamCompileCacheKeyPrefix(session, targetReq, keyBuilder);
+            keyBuilder << "glslang:" << int(request.action) << " " << int(request.slangStage) << " ";
+            keyBuilder << int(request.spirvVersion.major) << "." << int(request.spirvVersion.minor) << "." << int(request.spirvVersion.patch) << " ";
+            keyBuilder << int(linkage->optimizationLevel) << " " << int(linkage->debugInfoLevel) << "\n";
+            keyBuilder << "source:" << rawGLSL.getLength() << ":" << rawGLSL;
+            cacheKey = keyBuilder.ProduceString();
+
+            DownstreamDiagnostics cachedDiagnostics;
+            ComPtr<ISlangBlob> cachedBlob;
+            if (SLANG_SUCCEEDED(cache->find(cacheKey, cachedDiagnostics, cachedBlob)))
+            {
+                spirvOut.addRange((const uint8_t*)cachedBlob->getBufferPointer(), Index(cachedBlob->getBufferSize()));
+                return SLANG_OK;
+            }
+        }
+
         SLANG_RETURN_ON_FAIL(invokeGLSLCompiler(slangRequest, request));
+
+        if (cache)
+        {
+            // glslang doesn't report diagnostics for a successful compilation, so there are none to cache
+            DownstreamDiagnostics diagnostics;
+            ComPtr<ISlangBlob> blob = createRawBlob(spirvOut.getBuffer(), size_t(spirvOut.getCount()));
+            cache->add(cacheKey, diagnostics, blob);
+        }
         return SLANG_OK;
     }
 
@@ -2502,6 +2584,115 @@ SlangResult dissassembleDXILUsingDXC(
     }
 
 
+        /// A unit of back-end work that can run in parallel with others: generating
+        /// the code for one entry point (or a whole program) for one target.
+    struct BackEndJob : public RefObject
+    {
+        BackEndJob(DiagnosticSink* parentSink)
+            : sink(parentSink->getSourceManager())
+        {
+            sink.setFlags(parentSink->getFlags());
+        }
+
+        TargetProgram*                  targetProgram = nullptr;
+            /// The entry point to generate code for, or -1 if this is a whole program job
+        Int                             entryPointIndex = -1;
+            /// Diagnostics are buffered here, and appended to the request's sink in job order
+        DiagnosticSink                  sink;
+        RefPtr<BackEndCompileRequest>   compileRequest;
+            /// Set if the job threw, to be rethrown on the calling thread
+        std::exception_ptr              exception;
+    };
+
+        /// Generate the output for all targets like `generateOutputForTarget` does, but
+        /// run the (target, entry point) jobs on multiple threads.
+        ///
+        /// The output and diagnostics are the same as generating output serially: each job
+        /// reports to its own sink, and the sinks are appended in the order the jobs would
+        /// have run serially.
+    static void _generateOutputInParallel(
+        BackEndCompileRequest*  compileRequest,
+        EndToEndCompileRequest* endToEndReq)
+    {
+        auto sink = compileRequest->getSink();
+        auto linkage = compileRequest->getLinkage();
+        auto program = compileRequest->getProgram();
+        auto entryPointCount = program->getEntryPointCount();
+
+        // Anything that is lazily created and shared between jobs is created
+        // up front, here on the calling thread. That includes the target programs
+        // and their layouts, and space for the entry point results.
+        //
+        // The layout for a target would be created by its first job if done serially,
+        // so we use a job with no work to hold the diagnostics for it. (In pass-through
+        // mode no layout is needed.)
+        //
+        List<RefPtr<BackEndJob>> jobs;
+        List<RefPtr<BackEndJob>> workJobs;
+        for (auto targetReq : linkage->targets)
+        {
+            auto targetProgram = program->getTargetProgram(targetReq);
+
+            if (!isPassThroughEnabled(endToEndReq))
+            {
+                RefPtr<BackEndJob> layoutJob = new BackEndJob(sink);
+                jobs.add(layoutJob);
+                if (!targetProgram->getOrCreateIRModuleForLayout(&layoutJob->sink))
+                {
+                    continue;
+                }
+
+                // Linking uses the symbol index of each IR module, which is built on demand.
+                buildIRSymbolIndicesForLinking(compileRequest, targetProgram);
+            }
+
+            targetProgram->_reserveEntryPointResults(entryPointCount);
+
+            const Index jobEntryPointCount = targetReq->isWholeProgramRequest ? 1 : entryPointCount;
+            for (Index ii = 0; ii < jobEntryPointCount; ++ii)
+            {
+                RefPtr<BackEndJob> job = new BackEndJob(sink);
+                job->targetProgram = targetProgram;
+                job->entryPointIndex = targetReq->isWholeProgramRequest ? -1 : ii;
+                job->compileRequest = compileRequest->cloneWithSink(&job->sink);
+
+                jobs.add(job);
+                workJobs.add(job);
+            }
+        }
+
+        ParallelUtil::forEach(workJobs.getCount(), compileRequest->backEndThreadCount, [&](Index index)
+        {
+            BackEndJob* job = workJobs[index];
+            try
+            {
+                if (job->entryPointIndex < 0)
+                {
+                    job->targetProgram->_createWholeProgramResult(List<Int>(), job->compileRequest, endToEndReq);
+                }
+                else
+                {
+                    job->targetProgram->_createEntryPointResult(job->entryPointIndex, job->compileRequest, endToEndReq);
+                }
+            }
+            catch (...)
+            {
+                job->exception = std::current_exception();
+            }
+        });
+
+        // Report the diagnostics in order. If a job threw, the jobs after it
+        // wouldn't have run serially, so we stop and rethrow.
+        for (auto job : jobs)
+        {
+            sink->appendBufferedDiagnostics(job->sink);
+            if (job->exception)
+            {
+                std::rethrow_exception(job->exception);
+            }
+        }
+    }
+
     static void _generateOutput(
         BackEndCompileRequest* compileRequest,
         EndToEndCompileRequest* endToEndReq)
@@ -2541,6 +2732,17 @@ SlangResult dissassembleDXILUsingDXC(
         // has specified, and generate code for each of them.
         //
         auto linkage = compileRequest->getLinkage();
+
+        // A heterogeneous program emits the code for other targets
+        // (on demand) as part of emitting the CPU target, so the
+        // (target, entry point) pairs aren't independent.
+        //
+        if (compileRequest->backEndThreadCount != 1 && !linkage->m_heterogeneous)
+        {
+            _generateOutputInParallel(compileRequest, endToEndReq);
+            return;
+        }
+
         for (auto targetReq : linkage->targets)
         {
             generateOutputForTarget(compileRequest, targetReq, endToEndReq);
@@ -2563,33 +2765,70 @@ SlangResult dissassembleDXILUsingDXC(
 
         if (compileRequest->isCommandLineCompile)
         {
-            auto linkage = compileRequest->getLinkage();
-            auto program = compileRequest->getSpecializedGlobalAndEntryPointsComponentType();
-            for (auto targetReq : linkage->targets)
-            {
-                Index entryPointCount = program->getEntryPointCount();
-                if (targetReq->isWholeProgramRequest) {
-                    writeWholeProgramResult(
+            writeCommandLineOutput(compileRequest);
+        }
+    }
+
+    void writeCommandLineOutput(
+        EndToEndCompileRequest* compileRequest)
+    {
+        auto linkage = compileRequest->getLinkage();
+        auto program = compileRequest->getSpecializedGlobalAndEntryPointsComponentType();
+        for (auto targetReq : linkage->targets)
+        {
+            Index entryPointCount = program->getEntryPointCount();
+            if (targetReq->isWholeProgramRequest) {
+                writeWholeProgramResult(
+                    compileRequest,
+                    targetReq);
+            }
+            else {
+                for (Index ee = 0; ee < entryPointCount; ++ee)
+                {
+                    writeEntryPointResult(
+                        program,
                         compileRequest,
+                        ee,
                         targetReq);
                 }
-                else {
-                    for (Index ee = 0; ee < entryPointCount; ++ee)
-                    {
-                        writeEntryPointResult(
-                            program,
-                            compileRequest,
-                            ee,
-                            targetReq);
-                    }
-                }
             }
+        }
+
+        compileRequest->maybeCreateContainer();
+        compileRequest->maybeWriteContainer(compileRequest->m_containerOutputPath);
+    }
+
+    void prepareToGenerateOutputConcurrently(
+        EndToEndCompileRequest* compileRequest)
+    {
+        if (isPassThroughEnabled(compileRequest))
+        {
+            return;
+        }
+
+        auto backEndReq = compileRequest->getBackEndReq();
+        auto sink = backEndReq->getSink();
+        auto program = backEndReq->getProgram();
+        for (auto targetReq : compileRequest->getLinkage()->targets)
+        {
+            auto targetProgram = program->getTargetProgram(targetReq);
 
-            compileRequest->maybeCreateContainer();
-            compileRequest->maybeWriteContainer(compileRequest->m_containerOutputPath);
+            // Creating the IR for layout reads the AST of the modules the program uses, which
+            // can be shared. The symbol indices are built on the IR modules of the imported
+            // modules, which are shared.
+            if (targetProgram->getOrCreateIRModuleForLayout(sink))
+            {
+                buildIRSymbolIndicesForLinking(backEndReq, targetProgram);
+            }
         }
     }
 
+    void generateOutputWithoutWriting(
+        EndToEndCompileRequest* compileRequest)
+    {
+        _generateOutput(compileRequest->getBackEndReq(), compileRequest);
+    }
+
     // Debug logic for dumping intermediate outputs
 
     //
@@ -2608,13 +2847,8 @@ SlangResult dissassembleDXILUsingDXC(
         // This is primarily a debugging aid, so we don't
         // really need/want to do anything too elaborate
 
-        static uint32_t counter = 0;
-#ifdef WIN32
-        uint32_t id = InterlockedIncrement(&counter);
-#else
-        // TODO: actually implement the case for other platforms
-        uint32_t id = counter++;
-#endif
+        static std::atomic<uint32_t> counter(0);
+        uint32_t id = ++counter;
 
         String path;
         path.append(request->m_dumpIntermediatePrefix);
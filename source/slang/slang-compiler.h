@@ -5,6 +5,7 @@
 #include "../core/slang-shared-library.h"
 
 #include "../core/slang-downstream-compiler.h"
+#include "../core/slang-downstream-compile-cache.h"
 
 #include "../../slang-com-ptr.h"
 
@@ -20,10 +21,14 @@
 
 #include "../../slang.h"
 
+#include <mutex>
+
 namespace Slang
 {
     struct PathInfo;
     struct IncludeHandler;
+    class IRSpecializationCache;
+    class TokenCache;
     class ProgramLayout;
     class PtrType;
     class TargetProgram;
@@ -1284,6 +1289,12 @@ namespace Slang
 
         TypeCheckingCache* m_typeCheckingCache = nullptr;
 
+            /// Get the cache of the tokens lexed from files, so files that are included or imported
+            /// more than once (including by different compiles with this linkage) are only lexed once.
+        TokenCache* getTokenCache() { return m_tokenCache; }
+
+        RefPtr<TokenCache> m_tokenCache;
+
         // Modules that have been dynamically loaded via `import`
         //
         // This is a list of unique modules loaded, in the order they were encountered.
@@ -1392,6 +1403,14 @@ namespace Slang
         bool m_requireCacheFileSystem = false;
         bool m_useFalcorCustomSharedKeywordSemantics = false;
 
+            /// If set, modules that depend on a file whose content has changed are reloaded (see kSessionFlag_ReloadChangedModules)
+        bool m_reloadChangedModules = false;
+
+            /// Remove all of the loaded modules that depend on a file whose content has changed since the module
+            /// was loaded, such that they are loaded again the next time they are imported.
+            /// Only has an effect if m_reloadChangedModules is set.
+        void removeChangedModules();
+
         // Modules that have been read in with the -r option
         List<RefPtr<IRModule>> m_libModules;
 
@@ -1401,9 +1420,18 @@ namespace Slang
         }
 
     private:
+            /// Record the hash of the content of each file the module depends on
+        void _trackFileDependencies(Module* module);
+            /// Calculate the hash of the content of a file, as read through the linkage's file system
+        SlangResult _calcFileContentHash(String const& path, HashCode64& outHash);
+
             /// The global Slang library session that this linkage is a child of
         Session* m_session = nullptr;
 
+            /// Hash of the content of each file a loaded module depends on, as it was when the module was loaded.
+            /// Only used if m_reloadChangedModules is set.
+        Dictionary<String, HashCode64> m_fileContentHashes;
+
         RefPtr<Session> m_retainedSession;
 
 
@@ -1476,6 +1504,10 @@ namespace Slang
 
         bool shouldDumpIR = false;
         bool shouldValidateIR = false;
+        bool shouldReportIRMemory = false;
+        bool shouldTimePasses = false;
+        bool shouldReportSpecializationCache = false;
+        bool shouldReportSkippedIncludes = false;
 
         bool shouldDumpAST = false;
 
@@ -1484,6 +1516,8 @@ namespace Slang
             Linkage*        linkage,
             DiagnosticSink* sink);
 
+        void setSink(DiagnosticSink* sink) { m_sink = sink; }
+
     private:
         Linkage* m_linkage = nullptr;
         DiagnosticSink* m_sink = nullptr;
@@ -1702,6 +1736,14 @@ namespace Slang
             return m_entryPointResults[entryPointIndex];
         }
 
+            /// Make sure there is space for the results of `count` entry points, so
+            /// that results for different entry points can be created on different threads.
+        void _reserveEntryPointResults(Index count)
+        {
+            if (count > m_entryPointResults.getCount())
+                m_entryPointResults.setCount(count);
+        }
+
         CompileResult& _createWholeProgramResult(
             const List<Int>&        entryPointIndices,
             BackEndCompileRequest*  backEndRequest,
@@ -1781,6 +1823,15 @@ namespace Slang
 
         String m_dumpIntermediatePrefix;
 
+            /// The number of threads to use to generate code for (target, entry point) pairs in parallel.
+            ///
+            /// 1 (the default) generates code serially on the calling thread. 0 uses the number of
+            /// threads the hardware supports.
+        Index backEndThreadCount = 1;
+
+            /// Create a request with the same options and program as this one, that reports diagnostics to `sink`.
+        RefPtr<BackEndCompileRequest> cloneWithSink(DiagnosticSink* sink);
+
     private:
         RefPtr<ComponentType> m_program;
     };
@@ -1857,6 +1908,22 @@ namespace Slang
         };
         Dictionary<TargetRequest*, RefPtr<TargetInfo>> targetInfos;
 
+            /// A set of preprocessor definitions to compile the request with, as one of a batch
+        struct Permutation
+        {
+            Dictionary<String, String> preprocessorDefinitions;
+                /// The request the permutation was compiled with, which holds its output.
+                /// Set when the request is compiled.
+            RefPtr<EndToEndCompileRequest> request;
+        };
+            /// If there are any permutations, the request is compiled once for each of them (and not
+            /// once without them). The permutations share the linkage, so they share imported modules
+            /// and cached tokens, and generate code in parallel.
+        List<Permutation> permutations;
+
+            /// Add a permutation, returning its index
+        Index addPermutation();
+
             /// Writes the modules in a container to the stream
         SlangResult writeContainerToStream(Stream* stream);
         
@@ -1905,6 +1972,17 @@ namespace Slang
     private:
         void init();
 
+            /// Run the actions up to generating code (checking, specialization and layout).
+            /// Sets outIsComplete if there is no code to generate.
+        SlangResult _executeActionsBeforeCodeGen(bool& outIsComplete);
+
+            /// Compile each of the permutations
+        SlangResult _executePermutations();
+
+            /// Create a request on the same linkage with the same options as this one, plus the
+            /// definitions of the permutation at permutationIndex
+        RefPtr<EndToEndCompileRequest> _createPermutationRequest(Index permutationIndex);
+
         Session*                        m_session = nullptr;
         RefPtr<Linkage>                 m_linkage;
         DiagnosticSink                  m_sink;
@@ -1924,6 +2002,22 @@ namespace Slang
     void generateOutput(
         EndToEndCompileRequest* compileRequest);
 
+        /// Generate output for the request like `generateOutput`, but don't write it in command line mode.
+    void generateOutputWithoutWriting(
+        EndToEndCompileRequest* compileRequest);
+
+        /// Write the output of a command line compile to the requested files (or the standard output)
+    void writeCommandLineOutput(
+        EndToEndCompileRequest* compileRequest);
+
+        /// Create up front the state that generating output would create on demand from state that
+        /// can be shared with other requests on the same linkage (such as the AST and IR of imported modules).
+        ///
+        /// Once done, `generateOutputWithoutWriting` can run concurrently with other requests on the linkage
+        /// that have also been prepared.
+    void prepareToGenerateOutputConcurrently(
+        EndToEndCompileRequest* compileRequest);
+
     // Helper to dump intermediate output when debugging
     void maybeDumpIntermediate(
         BackEndCompileRequest* compileRequest,
@@ -2060,6 +2154,18 @@ namespace Slang
         SLANG_NO_THROW void SLANG_MCALL setLanguagePrelude(SlangSourceLanguage inSourceLanguage, char const* prelude) override;
         SLANG_NO_THROW void SLANG_MCALL getLanguagePrelude(SlangSourceLanguage inSourceLanguage, ISlangBlob** outPrelude) override;
 
+        SLANG_NO_THROW SlangResult SLANG_MCALL compileStdLib() override;
+        SLANG_NO_THROW SlangResult SLANG_MCALL loadStdLib(const void* stdLib, size_t stdLibSizeInBytes) override;
+        SLANG_NO_THROW SlangResult SLANG_MCALL saveStdLib(ISlangBlob** outBlob) override;
+        SLANG_NO_THROW SlangResult SLANG_MCALL setDownstreamCompileCache(char const* directory, SlangInt maxSizeInBytes) override;
+        SLANG_NO_THROW SlangResult SLANG_MCALL getDownstreamCompileCacheStats(slang::DownstreamCompileCacheStats* outStats) override;
+
+            /// Get the cache for downstream compilation results. Returns nullptr if results aren't cached.
+        DownstreamCompileCache* getDownstreamCompileCache() { return m_downstreamCompileCache; }
+
+            /// Get the cache of generic specializations shared by all compilations in the session
+        IRSpecializationCache* getIRSpecializationCache() { return m_irSpecializationCache; }
+
             /// Get the default compiler for a language
         DownstreamCompiler* getDefaultDownstreamCompiler(SourceLanguage sourceLanguage);
 
@@ -2133,8 +2239,13 @@ namespace Slang
             /// Get the prelude associated with the language
         const String& getPreludeForLanguage(SourceLanguage language) { return m_languagePreludes[int(language)]; }
 
+            /// Initialize the session. Does not set up the standard library.
         void init();
 
+            /// Set up the standard library. Will load a serialized standard library embedded
+            /// in the library if there is one, otherwise compiles it from source.
+        void initStdLib();
+
         void addBuiltinSource(
             RefPtr<Scope> const&    scope,
             String const&           path,
@@ -2151,16 +2262,30 @@ namespace Slang
         RefPtr<DownstreamCompiler> m_downstreamCompilers[int(PassThroughMode::CountOf)];        ///< A downstream compiler for a pass through
         DownstreamCompilerLocatorFunc m_downstreamCompilerLocators[int(PassThroughMode::CountOf)];
 
+        std::recursive_mutex m_downstreamCompilerMutex;                                         ///< Guards the lazy loading of downstream compilers and shared library functions
+
     private:
 
         SlangResult _loadRequest(EndToEndCompileRequest* request, const void* data, size_t size);
 
+            /// Add a (checked) stdlib module such that its declarations are visible from `scope`
+        void _addBuiltinModule(RefPtr<Scope> const& scope, Module* module);
+            /// Get the language scope a stdlib module was added to
+        Scope* _findBuiltinModuleScope(Module* module);
+            /// Hash of all of the source used to produce the stdlib
+        HashCode64 _calcStdLibSourceHash();
+            /// Makes the stdlib immutable, by evaluating any state that would otherwise be lazily evaluated
+            /// when it is used. This allows the stdlib to be used by compilations on multiple threads.
+        void _freezeStdLib();
+
             /// Linkage used for all built-in (stdlib) code.
         RefPtr<Linkage> m_builtinLinkage;
 
         String m_downstreamCompilerPaths[int(PassThroughMode::CountOf)];         ///< Paths for each pass through
         String m_languagePreludes[int(SourceLanguage::CountOf)];                  ///< Prelude for each source language
         PassThroughMode m_defaultDownstreamCompilers[int(SourceLanguage::CountOf)];
+        RefPtr<DownstreamCompileCache> m_downstreamCompileCache;                  ///< If set, downstream compilation results are cached
+        RefPtr<IRSpecializationCache> m_irSpecializationCache;
     };
 
 struct IncludeHandlerImpl : IncludeHandler
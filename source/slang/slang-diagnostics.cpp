@@ -269,6 +269,28 @@ void DiagnosticSink::diagnoseRaw(
     }
 }
 
+void DiagnosticSink::appendBufferedDiagnostics(DiagnosticSink const& other)
+{
+    SLANG_ASSERT(other.writer == nullptr);
+
+    m_errorCount += other.m_errorCount;
+
+    const auto& text = other.outputBuffer;
+    if (text.getLength() == 0)
+    {
+        return;
+    }
+
+    if (writer)
+    {
+        writer->write(text.getBuffer(), text.getLength());
+    }
+    else
+    {
+        outputBuffer.append(text);
+    }
+}
+
 namespace Diagnostics
 {
 #define DIAGNOSTIC(id, severity, name, messageFormat) const DiagnosticInfo name = { id, Severity::severity, #name, messageFormat };
@@ -191,6 +191,10 @@ namespace Slang
             /// error, note that this source location was involved
         void noteInternalErrorLoc(SourceLoc const& loc);
 
+            /// Report the diagnostics that have been buffered in `other` to this sink.
+            /// `other` must not have a writer set, so that its diagnostics are held in its `outputBuffer`.
+        void appendBufferedDiagnostics(DiagnosticSink const& other);
+
             /// Create a blob containing diagnostics if there were any errors.
             /// *note* only works if writer is not set, the blob is created from outputBuffer
         SlangResult getBlobIfNeeded(ISlangBlob** outBlob);
@@ -202,6 +206,8 @@ namespace Slang
 
             /// Get the flags
         Flags getFlags() const { return m_flags; }
+            /// Set all of the flags
+        void setFlags(Flags flags) { m_flags = flags; }
             /// Set a flag
         void setFlag(Flag::Enum flag) { m_flags |= Flags(flag); }
             /// Reset a flag
@@ -339,7 +339,7 @@ void CLikeSourceEmitter::emitTypeImpl(IRType* type, const StringSliceLoc* nameAn
 void CLikeSourceEmitter::emitType(IRType* type, Name* name)
 {
     SLANG_ASSERT(name);
-    StringSliceLoc nameAndLoc(name->text.getUnownedSlice());
+    StringSliceLoc nameAndLoc(name->text);
     emitType(type, &nameAndLoc);
 }
 
@@ -360,7 +360,7 @@ void CLikeSourceEmitter::emitType(IRType* type, Name* name, SourceLoc const& nam
 
     StringSliceLoc nameAndLoc;
     nameAndLoc.loc = nameLoc;
-    nameAndLoc.name = name->text.getUnownedSlice();
+    nameAndLoc.name = name->text;
     
     emitType(type, &nameAndLoc);
 }
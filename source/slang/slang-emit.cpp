@@ -16,6 +16,7 @@
 #include "slang-ir-insts.h"
 #include "slang-ir-legalize-varying-params.h"
 #include "slang-ir-link.h"
+#include "slang-ir-pass-manager.h"
 #include "slang-ir-lower-generics.h"
 #include "slang-ir-lower-tuple-types.h"
 #include "slang-ir-restructure.h"
@@ -139,6 +140,37 @@ static void dumpIRIfEnabled(
     }
 }
 
+static void reportIRMemoryIfEnabled(
+    BackEndCompileRequest*  compileRequest,
+    IRModule*               irModule,
+    char const*             label)
+{
+    if(compileRequest->shouldReportIRMemory)
+    {
+        DiagnosticSinkWriter writer(compileRequest->getSink());
+        dumpIRMemoryReport(irModule, &writer, label);
+    }
+}
+
+static void reportSpecializationCacheIfEnabled(
+    BackEndCompileRequest*  compileRequest,
+    LinkedIR const&         linkedIR)
+{
+    if(compileRequest->shouldReportSpecializationCache)
+    {
+        const auto& linkStats = linkedIR.specializationCacheStats;
+        const auto sessionStats = compileRequest->getSession()->getIRSpecializationCache()->getStats();
+
+        StringBuilder buf;
+        buf << "### SPECIALIZATION CACHE: " << linkStats.hitCount << " hits, " << linkStats.missCount << " misses, ";
+        buf << linkStats.savedInstCount << " instructions saved (session: " << sessionStats.hitCount << " hits, ";
+        buf << sessionStats.missCount << " misses, " << sessionStats.savedInstCount << " instructions saved)\n";
+
+        DiagnosticSinkWriter writer(compileRequest->getSink());
+        writer.write(buf.getBuffer(), buf.getLength());
+    }
+}
+
 struct LinkingAndOptimizationOptions
 {
     bool shouldLegalizeExistentialAndResourceTypes = true;
@@ -159,6 +191,12 @@ Result linkAndOptimizeIR(
 
     auto session = targetRequest->getSession();
 
+    // The passes are run by a pass manager, which validates the IR after
+    // each pass (if enabled), times each pass (if enabled), and skips
+    // passes that have nothing to do.
+    //
+    IRPassManager passManager(compileRequest);
+
     // We start out by performing "linking" at the level of the IR.
     // This step will create a fresh IR module to be used for
     // code generation, and will copy in any IR definitions that
@@ -167,33 +205,28 @@ Result linkAndOptimizeIR(
     // modules, and also select between the definitions of
     // any "profile-overloaded" symbols.
     //
-    outLinkedIR = linkIR(
-        compileRequest,
-        entryPointIndices,
-        target,
-        targetProgram);
+    passManager.run("linkIR", [&]()
+    {
+        outLinkedIR = linkIR(
+            compileRequest,
+            entryPointIndices,
+            target,
+            targetProgram);
+        passManager.setModule(outLinkedIR.module);
+    });
     auto irModule = outLinkedIR.module;
     auto irEntryPoints = outLinkedIR.entryPoints;
 
-#if 0
-    dumpIRIfEnabled(compileRequest, irModule, "LINKED");
-#endif
-
-    validateIRModuleIfEnabled(compileRequest, irModule);
-
     // If the user specified the flag that they want us to dump
     // IR, then do it here, for the target-specific, but
     // un-specialized IR.
     dumpIRIfEnabled(compileRequest, irModule);
+    reportIRMemoryIfEnabled(compileRequest, irModule, "LINKED");
+    reportSpecializationCacheIfEnabled(compileRequest, outLinkedIR);
 
     // Replace any global constants with their values.
     //
-    replaceGlobalConstants(irModule);
-#if 0
-    dumpIRIfEnabled(compileRequest, irModule, "GLOBAL CONSTANTS REPLACED");
-#endif
-    validateIRModuleIfEnabled(compileRequest, irModule);
-
+    passManager.run("replaceGlobalConstants", [&]() { replaceGlobalConstants(irModule); });
 
     // When there are top-level existential-type parameters
     // to the shader, we need to take the side-band information
@@ -202,11 +235,7 @@ Result linkAndOptimizeIR(
     // shader parameters for those slots, to be wired up to
     // use sites.
     //
-    bindExistentialSlots(irModule, sink);
-#if 0
-    dumpIRIfEnabled(compileRequest, irModule, "EXISTENTIALS BOUND");
-#endif
-    validateIRModuleIfEnabled(compileRequest, irModule);
+    passManager.run("bindExistentialSlots", [&]() { bindExistentialSlots(irModule, sink); });
 
     // Now that we've linked the IR code, any layout/binding
     // information has been attached to shader parameters
@@ -226,11 +255,10 @@ Result linkAndOptimizeIR(
     // can assume that all ordinary/uniform data is strictly
     // passed using constant buffers.
     //
-    collectGlobalUniformParameters(irModule, outLinkedIR.globalScopeVarLayout);
-#if 0
-    dumpIRIfEnabled(compileRequest, irModule, "GLOBAL UNIFORMS COLLECTED");
-#endif
-    validateIRModuleIfEnabled(compileRequest, irModule);
+    passManager.run("collectGlobalUniformParameters", [&]()
+    {
+        collectGlobalUniformParameters(irModule, outLinkedIR.globalScopeVarLayout);
+    });
 
     // Another transformation that needed to wait until we
     // had layout information on parameters is to take uniform
@@ -249,11 +277,7 @@ Result linkAndOptimizeIR(
         case CodeGenTarget::CPPSource:
             passOptions.alwaysCreateCollectedParam = true;
         default:
-            collectEntryPointUniformParams(irModule, passOptions);
-        #if 0
-            dumpIRIfEnabled(compileRequest, irModule, "ENTRY POINT UNIFORMS COLLECTED");
-        #endif
-            validateIRModuleIfEnabled(compileRequest, irModule);
+            passManager.run("collectEntryPointUniformParams", [&]() { collectEntryPointUniformParams(irModule, passOptions); });
             break;
         }
     }
@@ -261,11 +285,7 @@ Result linkAndOptimizeIR(
     switch( target )
     {
     default:
-        moveEntryPointUniformParamsToGlobalScope(irModule);
-    #if 0
-        dumpIRIfEnabled(compileRequest, irModule, "ENTRY POINT UNIFORMS MOVED");
-    #endif
-        validateIRModuleIfEnabled(compileRequest, irModule);
+        passManager.run("moveEntryPointUniformParamsToGlobalScope", [&]() { moveEntryPointUniformParamsToGlobalScope(irModule); });
         break;
 
     case CodeGenTarget::CPPSource:
@@ -273,15 +293,10 @@ Result linkAndOptimizeIR(
         break;
     }
 
-
     // Desguar any union types, since these will be illegal on
     // various targets.
     //
-    desugarUnionTypes(irModule);
-#if 0
-    dumpIRIfEnabled(compileRequest, irModule, "UNIONS DESUGARED");
-#endif
-    validateIRModuleIfEnabled(compileRequest, irModule);
+    passManager.runIfModuleHasOp("desugarUnionTypes", kIROp_TaggedUnionType, [&]() { desugarUnionTypes(irModule); });
 
     // Next, we need to ensure that the code we emit for
     // the target doesn't contain any operations that would
@@ -303,7 +318,7 @@ Result linkAndOptimizeIR(
     // values that need to be compile-time constants.
     //
     if (!compileRequest->allowDynamicCode)
-        specializeModule(irModule);
+        passManager.run("specializeModule", [&]() { specializeModule(irModule, &outLinkedIR.genericSpecializations); });
 
     switch (target)
     {
@@ -313,7 +328,7 @@ Result linkAndOptimizeIR(
         // function pointers.
         if (compileRequest->allowDynamicCode)
         {
-            lowerGenerics(irModule, sink);
+            passManager.run("lowerGenerics", [&]() { lowerGenerics(irModule, sink); });
             dumpIRIfEnabled(compileRequest, irModule, "LOWER-GENERICS");
         }
         break;
@@ -324,18 +339,12 @@ Result linkAndOptimizeIR(
     if (sink->getErrorCount() != 0)
         return SLANG_FAIL;
 
-    lowerTuples(irModule, sink);
+    passManager.runIfModuleHasOp("lowerTuples", kIROp_TupleType, [&]() { lowerTuples(irModule, sink); });
     if (sink->getErrorCount() != 0)
         return SLANG_FAIL;
 
     // TODO(DG): There are multiple DCE steps here, which need to be changed
     //   so that they don't just throw out any non-entry point code
-    // Debugging code for IR transformations...
-#if 0
-    dumpIRIfEnabled(compileRequest, irModule, "SPECIALIZED");
-#endif
-    validateIRModuleIfEnabled(compileRequest, irModule);
-
 
     // Specialization can introduce dead code that could trip
     // up downstream passes like type legalization, so we
@@ -344,11 +353,7 @@ Result linkAndOptimizeIR(
     // TODO: Are there other cleanup optimizations we should
     // apply at this point?
     //
-    eliminateDeadCode(irModule);
-#if 0
-    dumpIRIfEnabled(compileRequest, irModule, "AFTER DCE");
-#endif
-    validateIRModuleIfEnabled(compileRequest, irModule);
+    passManager.run("eliminateDeadCode", [&]() { eliminateDeadCode(irModule); });
 
     // We don't need the legalize pass for C/C++ based types
     if(options.shouldLegalizeExistentialAndResourceTypes )
@@ -379,15 +384,13 @@ Result linkAndOptimizeIR(
         //  we need to replace it with just an `X`, after which we
         //  will have (more) legal shader code.
         //
-        legalizeExistentialTypeLayout(
-            irModule,
-            sink);
-        eliminateDeadCode(irModule);
-
-#if 0
-        dumpIRIfEnabled(compileRequest, irModule, "EXISTENTIALS LEGALIZED");
-#endif
-        validateIRModuleIfEnabled(compileRequest, irModule);
+        passManager.run("legalizeExistentialTypeLayout", [&]()
+        {
+            legalizeExistentialTypeLayout(
+                irModule,
+                sink);
+            eliminateDeadCode(irModule);
+        });
 
         // Many of our target languages and/or downstream compilers
         // don't support `struct` types that have resource-type fields.
@@ -400,16 +403,13 @@ Result linkAndOptimizeIR(
         // What used to be individual variables/parameters/arguments/etc.
         // then become multiple variables/parameters/arguments/etc.
         //
-        legalizeResourceTypes(
-            irModule,
-            sink);
-        eliminateDeadCode(irModule);
-
-        //  Debugging output of legalization
-    #if 0
-        dumpIRIfEnabled(compileRequest, irModule, "LEGALIZED");
-    #endif
-        validateIRModuleIfEnabled(compileRequest, irModule);
+        passManager.run("legalizeResourceTypes", [&]()
+        {
+            legalizeResourceTypes(
+                irModule,
+                sink);
+            eliminateDeadCode(irModule);
+        });
     }
 
     // Once specialization and type legalization have been performed,
@@ -417,12 +417,7 @@ Result linkAndOptimizeIR(
     // to see if we can clean up any temporaries created by legalization.
     // (e.g., things that used to be aggregated might now be split up,
     // so that we can work with the individual fields).
-    constructSSA(irModule);
-
-#if 0
-    dumpIRIfEnabled(compileRequest, irModule, "AFTER SSA");
-#endif
-    validateIRModuleIfEnabled(compileRequest, irModule);
+    passManager.run("constructSSA", [&]() { constructSSA(irModule); });
 
     // After type legalization and subsequent SSA cleanup we expect
     // that any resource types passed to functions are exposed
@@ -441,22 +436,16 @@ Result linkAndOptimizeIR(
     // for D3D targets that are not okay for Vulkan), we
     // pass down the target request along with the IR.
     //
-    specializeResourceParameters(compileRequest, targetRequest, irModule);
+    passManager.run("specializeResourceParameters", [&]() { specializeResourceParameters(compileRequest, targetRequest, irModule); });
 
     // For GLSL targets, we also want to specialize calls to functions that
     // takes array parameters if possible, to avoid performance issues on
     // those platforms.
     if (isKhronosTarget(targetRequest))
     {
-        specializeArrayParameters(compileRequest, targetRequest, irModule);
+        passManager.run("specializeArrayParameters", [&]() { specializeArrayParameters(compileRequest, targetRequest, irModule); });
     }
 
-#if 0
-    dumpIRIfEnabled(compileRequest, irModule, "AFTER RESOURCE SPECIALIZATION");
-#endif
-
-    validateIRModuleIfEnabled(compileRequest, irModule);
-
     // For HLSL (and fxc/dxc) only, we need to "wrap" any
     // structured buffers defined over matrix types so
     // that they instead use an intermediate `struct`.
@@ -468,11 +457,18 @@ Result linkAndOptimizeIR(
     {
     case CodeGenTarget::HLSL:
         {
-            wrapStructuredBuffersOfMatrices(irModule);
-#if 0
-                dumpIRIfEnabled(compileRequest, irModule, "STRUCTURED BUFFERS WRAPPED");
-#endif
-                validateIRModuleIfEnabled(compileRequest, irModule);
+            static const IROp structuredBufferOps[] =
+            {
+                kIROp_HLSLStructuredBufferType,
+                kIROp_HLSLRWStructuredBufferType,
+                kIROp_HLSLRasterizerOrderedStructuredBufferType,
+                kIROp_HLSLAppendStructuredBufferType,
+                kIROp_HLSLConsumeStructuredBufferType,
+            };
+            passManager.runIfModuleHasOps("wrapStructuredBuffersOfMatrices", structuredBufferOps, SLANG_COUNT_OF(structuredBufferOps), [&]()
+            {
+                wrapStructuredBuffersOfMatrices(irModule);
+            });
         }
         break;
 
@@ -565,7 +561,11 @@ Result linkAndOptimizeIR(
             break;
         }
 
-        legalizeByteAddressBufferOps(session, irModule, byteAddressBufferOptions);
+        static const IROp byteAddressBufferOps[] = { kIROp_ByteAddressBufferLoad, kIROp_ByteAddressBufferStore };
+        passManager.runIfModuleHasOps("legalizeByteAddressBufferOps", byteAddressBufferOps, SLANG_COUNT_OF(byteAddressBufferOps), [&]()
+        {
+            legalizeByteAddressBufferOps(session, irModule, byteAddressBufferOptions);
+        });
     }
 
     // For CUDA targets only, we will need to turn operations
@@ -577,15 +577,13 @@ Result linkAndOptimizeIR(
     case CodeGenTarget::CUDASource:
     case CodeGenTarget::PTX:
         {
-            synthesizeActiveMask(
-                irModule,
-                compileRequest->getSink());
-
-#if 0
-            dumpIRIfEnabled(compileRequest, irModule, "AFTER synthesizeActiveMask");
-#endif
-            validateIRModuleIfEnabled(compileRequest, irModule);
-
+            passManager.run("synthesizeActiveMask", [&]()
+            {
+                synthesizeActiveMask(
+                    irModule,
+                    compileRequest->getSink(),
+                    passManager.getAnalysisCache());
+            });
         }
         break;
 
@@ -606,30 +604,28 @@ Result linkAndOptimizeIR(
     {
         auto glslExtensionTracker = as<GLSLExtensionTracker>(options.sourceEmitter->getExtensionTracker());
 
-        legalizeEntryPointsForGLSL(
-            session,
-            irModule,
-            irEntryPoints,
-            compileRequest->getSink(),
-            glslExtensionTracker);
-
-#if 0
-            dumpIRIfEnabled(compileRequest, irModule, "GLSL LEGALIZED");
-#endif
-            validateIRModuleIfEnabled(compileRequest, irModule);
+        passManager.run("legalizeEntryPointsForGLSL", [&]()
+        {
+            legalizeEntryPointsForGLSL(
+                session,
+                irModule,
+                irEntryPoints,
+                compileRequest->getSink(),
+                glslExtensionTracker);
+        });
     }
     break;
 
     case CodeGenTarget::CSource:
     case CodeGenTarget::CPPSource:
         {
-            legalizeEntryPointVaryingParamsForCPU(irModule, compileRequest->getSink());
+            passManager.run("legalizeEntryPointVaryingParamsForCPU", [&]() { legalizeEntryPointVaryingParamsForCPU(irModule, compileRequest->getSink()); });
         }
         break;
 
     case CodeGenTarget::CUDASource:
         {
-            legalizeEntryPointVaryingParamsForCUDA(irModule, compileRequest->getSink());
+            passManager.run("legalizeEntryPointVaryingParamsForCUDA", [&]() { legalizeEntryPointVaryingParamsForCUDA(irModule, compileRequest->getSink()); });
         }
         break;
 
@@ -645,16 +641,15 @@ Result linkAndOptimizeIR(
 
     case CodeGenTarget::CPPSource:
     case CodeGenTarget::CUDASource:
-        moveGlobalVarInitializationToEntryPoints(irModule);
-        introduceExplicitGlobalContext(irModule, target);
-        if(target == CodeGenTarget::CPPSource)
+        passManager.run("introduceExplicitGlobalContext", [&]()
         {
-            convertEntryPointPtrParamsToRawPtrs(irModule);
-        }
-    #if 0
-        dumpIRIfEnabled(compileRequest, irModule, "EXPLICIT GLOBAL CONTEXT INTRODUCED");
-    #endif
-        validateIRModuleIfEnabled(compileRequest, irModule);
+            moveGlobalVarInitializationToEntryPoints(irModule);
+            introduceExplicitGlobalContext(irModule, target);
+            if(target == CodeGenTarget::CPPSource)
+            {
+                convertEntryPointPtrParamsToRawPtrs(irModule);
+            }
+        });
         break;
     }
 
@@ -663,14 +658,9 @@ Result linkAndOptimizeIR(
         // For all targets that don't support true dynamic dispatch through
         // witness tables, we need to eliminate witness tables from the IR so
         // that they don't keep symbols live that we don't actually need.
-        stripWitnessTables(irModule);
+        passManager.runIfModuleHasOp("stripWitnessTables", kIROp_WitnessTable, [&]() { stripWitnessTables(irModule); });
     }
 
-#if 0
-    dumpIRIfEnabled(compileRequest, irModule, "AFTER STRIP WITNESS TABLES");
-#endif
-    validateIRModuleIfEnabled(compileRequest, irModule);
-
     // The resource-based specialization pass above
     // may create specialized versions of functions, but
     // it does not try to completely eliminate the original
@@ -681,11 +671,9 @@ Result linkAndOptimizeIR(
     // dead-code-elimination (DCE) pass that only retains
     // whatever code is "live."
     //
-    eliminateDeadCode(irModule);
-#if 0
-    dumpIRIfEnabled(compileRequest, irModule, "AFTER DCE");
-#endif
-    validateIRModuleIfEnabled(compileRequest, irModule);
+    passManager.run("eliminateDeadCode", [&]() { eliminateDeadCode(irModule); });
+
+    reportIRMemoryIfEnabled(compileRequest, irModule, "OPTIMIZED");
 
     return SLANG_OK;
 }
@@ -400,10 +400,7 @@ SlangResult HLSLIntrinsicSet::makeIntrinsic(IRInst* inst, HLSLIntrinsic& out)
 
 void HLSLIntrinsicSet::getIntrinsics(List<const HLSLIntrinsic*>& out) const
 {
-    for (auto& pair : m_intrinsics)
-    {
-        out.add(pair.Value);
-    }
+    out.addRange(m_intrinsicsInOrder.getBuffer(), m_intrinsicsInOrder.getCount());
 }
 
 HLSLIntrinsic* HLSLIntrinsicSet::add(const HLSLIntrinsic& intrinsic)
@@ -421,6 +418,7 @@ HLSLIntrinsic* HLSLIntrinsicSet::add(const HLSLIntrinsic& intrinsic)
         m_intrinsicFreeList.deallocate(copy);
         return *found;
     }
+    m_intrinsicsInOrder.add(copy);
     return copy;
 }
 
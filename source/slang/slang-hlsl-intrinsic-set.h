@@ -216,6 +216,9 @@ protected:
     void _calcIntrinsic(HLSLIntrinsic::Op op, IRType* returnType, IRType*const* inArgs, Index argsCount, HLSLIntrinsic& out);
     
     Dictionary<HLSLIntrinsicRef, HLSLIntrinsic*> m_intrinsics;
+        /// The intrinsics in the order they were added. The dictionary order depends on the
+        /// addresses of the types, so this is used to output them in a deterministic order.
+    List<const HLSLIntrinsic*> m_intrinsicsInOrder;
 
     FreeList m_intrinsicFreeList;           ///< the storage for the intrinsics when they are in the map
 
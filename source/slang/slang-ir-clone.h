@@ -1,7 +1,7 @@
 // slang-ir-clone.h
 #pragma once
 
-#include "../core/slang-dictionary.h"
+#include "../core/slang-flat-dictionary.h"
 
 #include "slang-ir.h"
 
@@ -34,7 +34,7 @@ struct SharedIRBuilder;
 struct IRCloneEnv
 {
         /// A mapping from old values to their replacements.
-    Dictionary<IRInst*, IRInst*> mapOldValToNew;
+    FlatDictionary<IRInst*, IRInst*> mapOldValToNew;
 
         /// A parent environment to fall back to if `mapOldValToNew` doesn't contain a key.
     IRCloneEnv* parent = nullptr;
@@ -236,7 +236,7 @@ struct CollectGlobalUniformParametersContext
                 // so that these loads can be merged/moved without concern
                 // for aliasing.
                 //
-                auto user = use->user;
+                auto user = use->getUser();
                 builder->setInsertBefore(user);
 
                 IRInst* value = nullptr;
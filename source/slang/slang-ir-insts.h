@@ -1660,8 +1660,8 @@ struct SharedIRBuilder
     // The module that will own all of the IR
     IRModule*       module;
 
-    Dictionary<IRInstKey,       IRInst*>    globalValueNumberingMap;
-    Dictionary<IRConstantKey,   IRConstant*>    constantMap;
+    FlatDictionary<IRInstKey,       IRInst*>    globalValueNumberingMap;
+    FlatDictionary<IRConstantKey,   IRConstant*>    constantMap;
 
     void insertBlockAlongEdge(IREdge const& edge);
 
@@ -5,6 +5,8 @@
 #include "slang-ir-insts.h"
 #include "slang-mangle.h"
 #include "slang-ir-string-hash.h"
+#include "slang-ir-specialization-cache.h"
+#include "slang-ir-specialize.h"
 
 namespace Slang
 {
@@ -28,7 +30,7 @@ struct IRSpecEnv
     IRSpecEnv*  parent = nullptr;
 
     // A map from original values to their cloned equivalents.
-    typedef Dictionary<IRInst*, IRInst*> ClonedValueDictionary;
+    typedef FlatDictionary<IRInst*, IRInst*> ClonedValueDictionary;
     ClonedValueDictionary clonedValues;
 };
 
@@ -40,10 +42,18 @@ struct IRSharedSpecContext
     // The specialized module we are building
     RefPtr<IRModule>   module;
 
+    // The *original* modules whose global values can be linked,
+    // in the order their symbols are considered.
+    List<IRModule*> originalModules;
+
     // A map from mangled symbol names to zero or
     // more global IR values that have that name,
-    // in the *original* module.
-    typedef Dictionary<String, RefPtr<IRSpecSymbol>> SymbolDictionary;
+    // in the original modules.
+    //
+    // Symbols are only added when first looked up, from the
+    // symbol indices of the original modules. The key is
+    // the name held by the first value.
+    typedef Dictionary<UnownedStringSlice, RefPtr<IRSpecSymbol>> SymbolDictionary;
     SymbolDictionary symbols;
 
     SharedIRBuilder sharedBuilderStorage;
@@ -51,8 +61,65 @@ struct IRSharedSpecContext
 
     // The "global" specialization environment.
     IRSpecEnv globalEnv;
+
+    // The session's cache of generic specializations, or nullptr
+    // if specializations aren't taken from the cache.
+    IRSpecializationCache* specializationCache = nullptr;
+
+    // The specializations that were taken from the cache, keyed by
+    // the generic and arguments they were looked up with.
+    List<KeyValuePair<IRSimpleSpecializationKey, IRInst*>> cachedSpecializations;
+    IRSpecializationCache::Stats specializationCacheStats;
 };
 
+    /// Find the global values in the original modules named `mangledName`, or nullptr if there are none.
+IRSpecSymbol* findSymbol(
+    IRSharedSpecContext*        sharedContext,
+    UnownedStringSlice const&   mangledName)
+{
+    if (auto found = sharedContext->symbols.TryGetValue(mangledName))
+    {
+        return *found;
+    }
+
+    // Look the name up in the index of each module. Each value
+    // found after the first is inserted right after the first,
+    // which is the order the values have always been considered in.
+    //
+    RefPtr<IRSpecSymbol> firstSym;
+    for (auto originalModule : sharedContext->originalModules)
+    {
+        auto symbolIndex = originalModule->getSymbolIndex();
+        const auto& entries = symbolIndex->getEntries();
+
+        for (Index i = symbolIndex->findFirstEntry(mangledName); i >= 0; i = entries[i].nextWithSameName)
+        {
+            RefPtr<IRSpecSymbol> sym = new IRSpecSymbol();
+            sym->irGlobalValue = entries[i].inst;
+
+            if (firstSym)
+            {
+                sym->nextWithSameName = firstSym->nextWithSameName;
+                firstSym->nextWithSameName = sym;
+            }
+            else
+            {
+                firstSym = sym;
+            }
+        }
+    }
+
+    // Names that aren't found aren't recorded, because the slice
+    // may not be held by anything that outlives this lookup.
+    //
+    if (firstSym)
+    {
+        auto linkage = firstSym->irGlobalValue->findDecoration<IRLinkageDecoration>();
+        sharedContext->symbols.Add(linkage->getMangledName(), firstSym);
+    }
+    return firstSym;
+}
+
 struct IRSpecContextBase
 {
     IRSharedSpecContext* shared;
@@ -61,8 +128,6 @@ struct IRSpecContextBase
 
     IRModule* getModule() { return getShared()->module; }
 
-    IRSharedSpecContext::SymbolDictionary& getSymbols() { return getShared()->symbols; }
-
     // The current specialization environment to use.
     IRSpecEnv* env = nullptr;
     IRSpecEnv* getEnv()
@@ -87,6 +152,15 @@ struct IRSpecContextBase
     {
         return originalVal;
     }
+
+    // A callback to be used when a `specialize` instruction in a block
+    // is cloned. It can return the already specialized value to use
+    // instead, in which case the instruction itself isn't cloned.
+    virtual IRInst* maybeCloneSpecialization(IRSpecialize* originalSpecialize)
+    {
+        SLANG_UNUSED(originalSpecialize);
+        return nullptr;
+    }
 };
 
 void registerClonedValue(
@@ -203,11 +277,16 @@ struct IRSpecContext : IRSpecContextBase
 {
     // Override the "maybe clone" logic so that we always clone
     virtual IRInst* maybeCloneValue(IRInst* originalVal) override;
+
+    // Use the session's specialization cache where possible
+    virtual IRInst* maybeCloneSpecialization(IRSpecialize* originalSpecialize) override;
 };
 
 
 IRInst* cloneGlobalValue(IRSpecContext* context, IRInst* originalVal);
 
+IRInst* cloneCachedSpecialization(IRSpecContext* context, IRSpecialize* originalSpecialize);
+
 IRInst* cloneValue(
     IRSpecContextBase*  context,
     IRInst*        originalValue);
@@ -216,8 +295,19 @@ IRType* cloneType(
     IRSpecContextBase*  context,
     IRType*             originalType);
 
+IRInst* IRSpecContext::maybeCloneSpecialization(IRSpecialize* originalSpecialize)
+{
+    return cloneCachedSpecialization(this, originalSpecialize);
+}
+
 IRInst* IRSpecContext::maybeCloneValue(IRInst* originalValue)
 {
+    if (auto originalSpecialize = as<IRSpecialize>(originalValue))
+    {
+        if (auto clonedValue = cloneCachedSpecialization(this, originalSpecialize))
+            return clonedValue;
+    }
+
     switch (originalValue->op)
     {
     case kIROp_StructType:
@@ -813,12 +903,13 @@ IRFunc* specializeIRForEntryPoint(
     // so that the mangled name of the decl-ref is
     // not the same as the mangled name of the decl.
     //
-    RefPtr<IRSpecSymbol> sym;
-    if (!context->getSymbols().TryGetValue(mangledName, sym))
+    IRSpecSymbol* sym = findSymbol(context->getShared(), mangledName.getUnownedSlice());
+    if (!sym)
     {
         String hashedName = getHashedName(mangledName.getUnownedSlice());
 
-        if (!context->getSymbols().TryGetValue(hashedName, sym))
+        sym = findSymbol(context->getShared(), hashedName.getUnownedSlice());
+        if (!sym)
         {
             SLANG_UNEXPECTED("no matching IR symbol");
             return nullptr;
@@ -1114,6 +1205,14 @@ IRInst* cloneInst(
     case kIROp_GlobalGenericParam:
         return cloneGlobalGenericParamImpl(context, builder, cast<IRGlobalGenericParam>(originalInst), originalValues);
 
+    case kIROp_Specialize:
+        if (auto clonedValue = context->maybeCloneSpecialization(cast<IRSpecialize>(originalInst)))
+        {
+            registerClonedValue(context, clonedValue, originalValues);
+            return clonedValue;
+        }
+        break;
+
     default:
         break;
     }
@@ -1155,6 +1254,21 @@ IRInst* cloneGlobalValueImpl(
 
     /// Clone a global value, which has the given `originalLinkage`.
     ///
+    /// Find the value in `sym` (or the values with the same name) that is best for the target.
+IRInst* findBestValueForTarget(
+    IRSpecContext*  context,
+    IRSpecSymbol*   sym)
+{
+    IRInst* bestVal = nullptr;
+    for(IRSpecSymbol* ss = sym; ss; ss = ss->nextWithSameName )
+    {
+        IRInst* newVal = ss->irGlobalValue;
+        if (isBetterForTarget(context, newVal, bestVal))
+            bestVal = newVal;
+    }
+    return bestVal;
+}
+
     /// The `originalVal` is a known global IR value with that linkage, if one is available.
     /// (It is okay for this parameter to be null).
     ///
@@ -1194,9 +1308,8 @@ IRInst* cloneGlobalValueWithLinkage(
     // with the same mangled name as `originalVal` and try
     // to pick the "best" one for our target.
 
-    auto mangledName = String(originalLinkage->getMangledName());
-    RefPtr<IRSpecSymbol> sym;
-    if( !context->getSymbols().TryGetValue(mangledName, sym) )
+    IRSpecSymbol* sym = findSymbol(context->getShared(), originalLinkage->getMangledName());
+    if( !sym )
     {
         if(!originalVal)
             return nullptr;
@@ -1212,14 +1325,7 @@ IRInst* cloneGlobalValueWithLinkage(
     // more specialized for the chosen target. Otherwise, we simply favor
     // definitions over declarations.
     //
-    IRInst* bestVal = nullptr;
-    for(IRSpecSymbol* ss = sym; ss; ss = ss->nextWithSameName )
-    {
-        IRInst* newVal = ss->irGlobalValue;
-        if (isBetterForTarget(context, newVal, bestVal))
-            bestVal = newVal;
-    }
-
+    IRInst* bestVal = findBestValueForTarget(context, sym);
     if (!bestVal)
     {
         return nullptr;
@@ -1253,48 +1359,149 @@ IRInst* cloneGlobalValue(IRSpecContext* context, IRInst* originalVal)
         originalVal->findDecoration<IRLinkageDecoration>());
 }
 
-void insertGlobalValueSymbol(
-    IRSharedSpecContext*    sharedContext,
-    IRInst*                 gv)
+IRInst* findCachedSpecialization(
+    IRSpecContext*  context,
+    IRSpecialize*   originalSpecialize,
+    IRSimpleSpecializationKey* outKey = nullptr);
+
+    /// Get the value that identifies `originalVal` when it is part of the key for a cached
+    /// specialization, or nullptr if it can't be part of a key.
+    ///
+    /// The value must not depend on anything that is only known after linking (like
+    /// global generic parameters, or values that later passes replace), so that a
+    /// specialization in the cache is the same as the specialization that would be
+    /// made after linking. Anything with target specific versions is identified by the
+    /// version that is best for the target.
+    ///
+static IRInst* _getSpecializationKeyVal(
+    IRSpecContext*  context,
+    IRInst*         originalVal)
 {
-    auto linkage = gv->findDecoration<IRLinkageDecoration>();
+    auto shared = context->getShared();
 
-    // Don't try to register a symbol for global values
-    // that don't have linkage.
-    //
-    if (!linkage)
-        return;
+    if (!originalVal)
+        return nullptr;
 
-    auto mangledName = String(linkage->getMangledName());
+    // A nested specialization is identified by its value in the cache.
+    if (auto originalSpecialize = as<IRSpecialize>(originalVal))
+        return findCachedSpecialization(context, originalSpecialize);
 
-    RefPtr<IRSpecSymbol> sym = new IRSpecSymbol();
-    sym->irGlobalValue = gv;
+    if (shared->specializationCache->isCachedValue(originalVal))
+        return originalVal;
 
-    RefPtr<IRSpecSymbol> prev;
-    if (sharedContext->symbols.TryGetValue(mangledName, prev))
+    // Anything not at global scope depends on something local,
+    // such as the parameter of an enclosing generic.
+    if (!as<IRModuleInst>(originalVal->getParent()))
+        return nullptr;
+
+    if (auto linkage = originalVal->findDecoration<IRLinkageDecoration>())
     {
-        sym->nextWithSameName = prev->nextWithSameName;
-        prev->nextWithSameName = sym;
+        switch (originalVal->op)
+        {
+        case kIROp_StructType:
+        case kIROp_InterfaceType:
+        case kIROp_WitnessTable:
+        case kIROp_Generic:
+            return findBestValueForTarget(context, findSymbol(shared, linkage->getMangledName()));
+
+        default:
+            return nullptr;
+        }
     }
-    else
+
+    switch (originalVal->op)
+    {
+    case kIROp_BoolLit:
+    case kIROp_IntLit:
+    case kIROp_FloatLit:
+        break;
+
+    // Types that are replaced or legalized after linking
+    case kIROp_AnyValueType:
+    case kIROp_AssociatedType:
+    case kIROp_BindExistentialsType:
+    case kIROp_ExistentialBoxType:
+    case kIROp_TaggedUnionType:
+    case kIROp_ThisType:
+        return nullptr;
+
+    default:
+        if (!as<IRType>(originalVal))
+            return nullptr;
+        break;
+    }
+
+    // A type or constant is identified by itself, as long as everything it
+    // is made from identifies itself too.
+    if (auto type = originalVal->getFullType())
     {
-        sharedContext->symbols.Add(mangledName, sym);
+        if (_getSpecializationKeyVal(context, type) != type)
+            return nullptr;
+    }
+    const UInt operandCount = originalVal->getOperandCount();
+    for (UInt i = 0; i < operandCount; ++i)
+    {
+        auto operand = originalVal->getOperand(i);
+        if (_getSpecializationKeyVal(context, operand) != operand)
+            return nullptr;
     }
+    return originalVal;
 }
 
-void insertGlobalValueSymbols(
-    IRSharedSpecContext*    sharedContext,
-    IRModule*               originalModule)
+    /// Find (or add) the specialization for `originalSpecialize` in the session's specialization
+    /// cache. Returns nullptr if it can't be cached.
+IRInst* findCachedSpecialization(
+    IRSpecContext*              context,
+    IRSpecialize*               originalSpecialize,
+    IRSimpleSpecializationKey*  outKey)
 {
-    if (!originalModule)
-        return;
+    auto shared = context->getShared();
+    if (!shared->specializationCache)
+        return nullptr;
+
+    auto generic = as<IRGeneric>(_getSpecializationKeyVal(context, originalSpecialize->getBase()));
+    if (!generic || !canSpecializeGeneric(generic))
+        return nullptr;
 
-    for(auto ii : originalModule->getGlobalInsts())
+    List<IRInst*> args;
+    const UInt argCount = originalSpecialize->getArgCount();
+    for (UInt i = 0; i < argCount; ++i)
     {
-        insertGlobalValueSymbol(sharedContext, ii);
+        auto arg = _getSpecializationKeyVal(context, originalSpecialize->getArg(i));
+        if (!arg)
+            return nullptr;
+        args.add(arg);
     }
+
+    if (outKey)
+    {
+        outKey->vals.add(generic);
+        outKey->vals.addRange(args);
+    }
+
+    return shared->specializationCache->getSpecialization(generic, args.getBuffer(), args.getCount(), &shared->specializationCacheStats);
+}
+
+    /// If the specialization `originalSpecialize` can be cached, clone the
+    /// specialized value from the cache. Otherwise returns nullptr, and the
+    /// specialization is left to `specializeModule`.
+IRInst* cloneCachedSpecialization(
+    IRSpecContext*  context,
+    IRSpecialize*   originalSpecialize)
+{
+    IRSimpleSpecializationKey key;
+    auto cachedVal = findCachedSpecialization(context, originalSpecialize, &key);
+    if (!cachedVal)
+        return nullptr;
+
+    auto clonedVal = cloneValue(context, cachedVal);
+    registerClonedValue(context, clonedVal, originalSpecialize);
+
+    context->getShared()->cachedSpecializations.add(KeyValuePair<IRSimpleSpecializationKey, IRInst*>(key, cachedVal));
+    return clonedVal;
 }
 
+
 void initializeSharedSpecContext(
     IRSharedSpecContext*    sharedContext,
     Session*                session,
@@ -1346,6 +1553,49 @@ struct IRSpecializationState
     }
 };
 
+    /// Get the IR modules the program for targetProgram depends on (including modules loaded as libraries) as
+    /// outIRModules, and all of the modules whose symbols can be linked as outModulesToLink.
+    ///
+    /// The modules to link also include the IR module for the layout of `targetProgram` (if there is one),
+    /// since this module is responsible for associating layout information to the global symbols via decorations.
+static void _getModulesToLink(
+    BackEndCompileRequest*  compileRequest,
+    TargetProgram*          targetProgram,
+    List<IRModule*>&        outIRModules,
+    List<IRModule*>&        outModulesToLink)
+{
+    auto program = compileRequest->getProgram();
+    auto linkage = compileRequest->getLinkage();
+
+    outIRModules.clear();
+    program->enumerateIRModules([&](IRModule* irModule)
+    {
+        outIRModules.add(irModule);
+    });
+    // Add any modules that were loaded as libraries
+    outIRModules.addRange(linkage->m_libModules.getBuffer()->readRef(), linkage->m_libModules.getCount());
+
+    outModulesToLink = outIRModules;
+    if (auto irModuleForLayout = targetProgram->getExistingIRModuleForLayout())
+    {
+        outModulesToLink.add(irModuleForLayout);
+    }
+}
+
+void buildIRSymbolIndicesForLinking(
+    BackEndCompileRequest*  compileRequest,
+    TargetProgram*          targetProgram)
+{
+    List<IRModule*> irModules;
+    List<IRModule*> modulesToLink;
+    _getModulesToLink(compileRequest, targetProgram, irModules, modulesToLink);
+
+    for (auto irModule : modulesToLink)
+    {
+        irModule->getSymbolIndex();
+    }
+}
+
 LinkedIR linkIR(
     BackEndCompileRequest*  compileRequest,
     const List<Int>&        entryPointIndices,
@@ -1375,35 +1625,23 @@ LinkedIR linkIR(
 
     state->irModule = sharedContext->module;
 
-    auto linkage = compileRequest->getLinkage();
+    // Specializations of generics are taken from the session's cache
+    // as they are linked, unless generics are kept for dynamic dispatch.
+    //
+    if (!compileRequest->allowDynamicCode)
+    {
+        sharedContext->specializationCache = compileRequest->getSession()->getIRSpecializationCache();
+    }
 
     // We need to be able to look up IR definitions for any symbols in
     // modules that the program depends on (transitively). To
-    // accelerate lookup, we will create a symbol table for looking
-    // up IR definitions by their mangled name.
+    // accelerate lookup, each module has an index of its IR definitions
+    // by their mangled name, which is built once and reused by every link.
     //
-
     List<IRModule*> irModules;
-    program->enumerateIRModules([&](IRModule* irModule)
-    {
-        irModules.add(irModule);
-    });
-    irModules.addRange(linkage->m_libModules.getBuffer()->readRef(), linkage->m_libModules.getCount());
+    _getModulesToLink(compileRequest, targetProgram, irModules, sharedContext->originalModules);
 
-    
-    // Add any modules that were loaded as libraries
-    for (IRModule* irModule : irModules)
-    {
-        insertGlobalValueSymbols(sharedContext, irModule);
-    }
-
-    // We will also insert the IR global symbols from the IR module
-    // attached to the `TargetProgram`, since this module is
-    // responsible for associating layout information to those
-    // global symbols via decorations.
-    //
     auto irModuleForLayout = targetProgram->getExistingIRModuleForLayout();
-    insertGlobalValueSymbols(sharedContext, irModuleForLayout);
 
     auto context = state->getContext();
 
@@ -1430,10 +1668,29 @@ LinkedIR linkIR(
     // TODO: This step should *not* be needed with the current IR
     // specialization approach, so we should consider removing it.
     //
-    for (auto sym : context->getSymbols())
+    // Only the first value with a given name is cloned, as `cloneGlobalValue`
+    // will find the others.
+    //
     {
-        if (sym.Value->irGlobalValue->op == kIROp_WitnessTable)
-            cloneGlobalValue(context, (IRWitnessTable*)sym.Value->irGlobalValue);
+        const auto& originalModules = sharedContext->originalModules;
+        for (Index moduleIndex = 0; moduleIndex < originalModules.getCount(); ++moduleIndex)
+        {
+            auto symbolIndex = originalModules[moduleIndex]->getSymbolIndex();
+            for (auto entryIndex : symbolIndex->getWitnessTableEntries())
+            {
+                auto witnessTable = symbolIndex->getEntries()[entryIndex].inst;
+                auto mangledName = witnessTable->findDecoration<IRLinkageDecoration>()->getMangledName();
+
+                bool isFirst = true;
+                for (Index i = 0; isFirst && i < moduleIndex; ++i)
+                {
+                    isFirst = originalModules[i]->getSymbolIndex()->findFirstEntry(mangledName) < 0;
+                }
+
+                if (isFirst)
+                    cloneGlobalValue(context, (IRWitnessTable*)witnessTable);
+            }
+        }
     }
 
     // Next, we make sure to clone the global value for
@@ -1477,29 +1734,22 @@ LinkedIR linkIR(
     // `[bindExistentialSlots(...)]` works, so that they can be attached
     // to the relevant parameters and cloned via `cloneExtraDecorations`.
     // In the long run we do not want to *ever* iterate over all the
-    // instructions in all the input modules.
+    // instructions in all the input modules. For now the symbol index
+    // of each module records them, so at least that only happens once.
     //
     
     for (IRModule* irModule : irModules)
     {
-        for (auto inst : irModule->getGlobalInsts())
+        for (auto bindInst : irModule->getSymbolIndex()->getGlobalGenericParamBindings())
         {
-            auto bindInst = as<IRBindGlobalGenericParam>(inst);
-            if (!bindInst)
-                continue;
-
             cloneValue(context, bindInst);
         }
     }
 
     for (IRModule* irModule : irModules)
     {
-        for (auto inst : irModule->getGlobalInsts())
+        for (auto inst : irModule->getSymbolIndex()->getPublicValues())
         {
-            auto hasPublic = inst->findDecoration<IRPublicDecoration>();
-            if (!hasPublic)
-                continue;
-
             auto cloned = cloneValue(context, inst);
             if (!cloned->findDecorationImpl(kIROp_KeepAliveDecoration))
             {
@@ -1530,6 +1780,32 @@ LinkedIR linkIR(
     linkedIR.module = state->irModule;
     linkedIR.globalScopeVarLayout = irGlobalScopeVarLayout;
     linkedIR.entryPoints = irEntryPoints;
+    linkedIR.specializationCacheStats = sharedContext->specializationCacheStats;
+
+    // The generic and arguments of a specialization taken from the cache may
+    // also have been linked, in which case `specializeModule` could find the
+    // same specialization in the linked module. It needs to use the value
+    // from the cache, or there would be two different versions of it.
+    //
+    for (const auto& cachedSpecialization : sharedContext->cachedSpecializations)
+    {
+        IRSimpleSpecializationKey key;
+        for (auto val : cachedSpecialization.Key.vals)
+        {
+            auto clonedVal = findClonedValue(context, val);
+            if (!clonedVal)
+                break;
+            key.vals.add(clonedVal);
+        }
+        if (key.vals.getCount() != cachedSpecialization.Key.vals.getCount())
+            continue;
+
+        if (auto clonedValue = findClonedValue(context, cachedSpecialization.Value))
+        {
+            linkedIR.genericSpecializations[key] = clonedValue;
+        }
+    }
+
     return linkedIR;
 }
 
@@ -2,6 +2,8 @@
 #pragma once
 
 #include "slang-compiler.h"
+#include "slang-ir-clone.h"
+#include "slang-ir-specialization-cache.h"
 
 namespace Slang
 {
@@ -12,6 +14,12 @@ namespace Slang
         RefPtr<IRModule>    module;
         IRVarLayout*        globalScopeVarLayout;
         List<IRFunc*>       entryPoints;
+
+            /// Specializations of generics in `module` that were made when linking,
+            /// for `specializeModule` to use.
+        Dictionary<IRSimpleSpecializationKey, IRInst*> genericSpecializations;
+            /// Use of the session's specialization cache when linking
+        IRSpecializationCache::Stats specializationCacheStats;
     };
 
 
@@ -27,6 +35,16 @@ namespace Slang
         CodeGenTarget           target,
         TargetProgram*          targetProgram);
 
+    // Build the symbol index of each IR module that `linkIR` could
+    // link for `targetProgram`, if it isn't already built.
+    //
+    // The indices are otherwise built on demand, so this must be
+    // called before linking on multiple threads.
+    //
+    void buildIRSymbolIndicesForLinking(
+        BackEndCompileRequest*  compileRequest,
+        TargetProgram*          targetProgram);
+
     // Replace any global constants in the IR module with their
     // definitions, if possible.
     //
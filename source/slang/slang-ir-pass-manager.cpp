@@ -0,0 +1,237 @@
+// slang-ir-pass-manager.cpp
+#include "slang-ir-pass-manager.h"
+
+#include "../core/slang-process-util.h"
+
+#include "slang-compiler.h"
+#include "slang-ir-validate.h"
+
+namespace Slang
+{
+
+// IRAnalysisCache
+
+IRDominatorTree* IRAnalysisCache::getDominatorTree(IRGlobalValueWithCode* code)
+{
+    if (auto found = m_dominatorTrees.TryGetValue(code))
+    {
+        return *found;
+    }
+    RefPtr<IRDominatorTree> tree = computeDominatorTree(code);
+    m_dominatorTrees.Add(code, tree);
+    return tree;
+}
+
+void IRAnalysisCache::invalidate()
+{
+    m_dominatorTrees = Dictionary<IRGlobalValueWithCode*, RefPtr<IRDominatorTree>>();
+}
+
+// IRPassManager
+
+IRPassManager::IRPassManager(BackEndCompileRequest* compileRequest, IRModule* module):
+    m_compileRequest(compileRequest),
+    m_module(module)
+{
+    m_shouldTimePasses = compileRequest->shouldTimePasses;
+}
+
+IRPassManager::~IRPassManager()
+{
+    // Written here, so there is a report even if the pipeline stops early because of an error
+    if (m_shouldTimePasses)
+    {
+        _writeReport();
+    }
+}
+
+void IRPassManager::setModule(IRModule* module)
+{
+    m_module = module;
+    m_areModuleOpsValid = false;
+    m_analysisCache.invalidate();
+}
+
+void IRPassManager::_calcModuleOps()
+{
+    m_moduleOps.resizeAndClear(kIROpMeta_OpMask + 1);
+    m_moduleInstCount = 0;
+
+    if (m_module)
+    {
+        List<IRInst*> workList;
+        workList.add(m_module->getModuleInst());
+        while (workList.getCount())
+        {
+            IRInst* inst = workList.getLast();
+            workList.removeLast();
+
+            m_moduleOps.add(inst->op & kIROpMeta_OpMask);
+            m_moduleInstCount++;
+
+            for (auto child : inst->getDecorationsAndChildren())
+            {
+                workList.add(child);
+            }
+        }
+    }
+
+    m_areModuleOpsValid = true;
+}
+
+bool IRPassManager::_moduleHasOps(IROp const* ops, Index opCount)
+{
+    if (!m_areModuleOpsValid)
+    {
+        _calcModuleOps();
+    }
+    for (Index i = 0; i < opCount; ++i)
+    {
+        if (m_moduleOps.contains(ops[i] & kIROpMeta_OpMask))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void IRPassManager::_beginPass(char const* name)
+{
+    if (m_shouldTimePasses)
+    {
+        if (!m_areModuleOpsValid)
+        {
+            _calcModuleOps();
+        }
+
+        PassRecord record;
+        record.name = name;
+        record.wasSkipped = false;
+        record.seconds = 0;
+        record.instCountBefore = m_moduleInstCount;
+        record.instCountAfter = m_moduleInstCount;
+        record.arenaSizeInBytes = 0;
+        m_passRecords.add(record);
+
+        // Start timing last, so the time doesn't include counting the instructions
+        m_passStartTick = ProcessUtil::getClockTick();
+    }
+}
+
+void IRPassManager::_endPass()
+{
+    // The pass may have changed anything
+    m_areModuleOpsValid = false;
+    m_analysisCache.invalidate();
+
+    if (m_shouldTimePasses)
+    {
+        PassRecord& record = m_passRecords.getLast();
+        record.seconds = double(ProcessUtil::getClockTick() - m_passStartTick) / ProcessUtil::getClockFrequency();
+
+        _calcModuleOps();
+        record.instCountAfter = m_moduleInstCount;
+        // The arena only grows, so its size after the pass is the peak during the pass
+        record.arenaSizeInBytes = m_module ? m_module->memoryArena.calcTotalMemoryUsed() : 0;
+    }
+
+    if (m_module)
+    {
+        validateIRModuleIfEnabled(m_compileRequest, m_module);
+    }
+}
+
+void IRPassManager::_skipPass(char const* name)
+{
+    if (m_shouldTimePasses)
+    {
+        PassRecord record;
+        record.name = name;
+        record.wasSkipped = true;
+        record.seconds = 0;
+        record.instCountBefore = m_moduleInstCount;
+        record.instCountAfter = m_moduleInstCount;
+        record.arenaSizeInBytes = m_module ? m_module->memoryArena.calcTotalMemoryUsed() : 0;
+        m_passRecords.add(record);
+    }
+}
+
+static void _appendPadded(StringBuilder& buf, const UnownedStringSlice& text, Index width, bool alignRight)
+{
+    const Index padCount = width - text.getLength();
+    if (!alignRight)
+    {
+        buf << text;
+    }
+    for (Index i = 0; i < padCount; ++i)
+    {
+        buf << ' ';
+    }
+    if (alignRight)
+    {
+        buf << text;
+    }
+}
+
+void IRPassManager::_writeReport()
+{
+    StringBuilder buf;
+    buf << "### PASS TIMES:\n";
+
+    const Index nameWidth = 40;
+    const Index columnWidth = 12;
+
+    _appendPadded(buf, UnownedStringSlice::fromLiteral("pass"), nameWidth, false);
+    _appendPadded(buf, UnownedStringSlice::fromLiteral("time (ms)"), columnWidth, true);
+    _appendPadded(buf, UnownedStringSlice::fromLiteral("insts"), columnWidth, true);
+    _appendPadded(buf, UnownedStringSlice::fromLiteral("delta"), columnWidth, true);
+    _appendPadded(buf, UnownedStringSlice::fromLiteral("arena (KB)"), columnWidth, true);
+    buf << "\n";
+
+    double totalSeconds = 0;
+    for (const auto& record : m_passRecords)
+    {
+        _appendPadded(buf, UnownedStringSlice(record.name), nameWidth, false);
+        if (record.wasSkipped)
+        {
+            _appendPadded(buf, UnownedStringSlice::fromLiteral("skipped"), columnWidth, true);
+        }
+        else
+        {
+            char text[32];
+            sprintf_s(text, SLANG_COUNT_OF(text), "%.3f", record.seconds * 1000.0);
+            _appendPadded(buf, UnownedStringSlice(text), columnWidth, true);
+        }
+
+        const Index delta = record.instCountAfter - record.instCountBefore;
+
+        StringBuilder column;
+        column << record.instCountAfter;
+        _appendPadded(buf, column.getUnownedSlice(), columnWidth, true);
+
+        column.Clear();
+        column << ((delta > 0) ? "+" : "") << delta;
+        _appendPadded(buf, column.getUnownedSlice(), columnWidth, true);
+
+        column.Clear();
+        column << UInt((record.arenaSizeInBytes + 1023) / 1024);
+        _appendPadded(buf, column.getUnownedSlice(), columnWidth, true);
+        buf << "\n";
+
+        totalSeconds += record.seconds;
+    }
+
+    {
+        char text[32];
+        sprintf_s(text, SLANG_COUNT_OF(text), "%.3f", totalSeconds * 1000.0);
+        _appendPadded(buf, UnownedStringSlice::fromLiteral("total"), nameWidth, false);
+        _appendPadded(buf, UnownedStringSlice(text), columnWidth, true);
+        buf << "\n###\n";
+    }
+
+    DiagnosticSinkWriter writer(m_compileRequest->getSink());
+    writer.write(buf.getBuffer(), buf.getLength());
+    writer.flush();
+}
+
+}
@@ -0,0 +1,109 @@
+// slang-ir-pass-manager.h
+#pragma once
+
+#include "../core/slang-basic.h"
+#include "../core/slang-uint-set.h"
+
+#include "slang-ir.h"
+#include "slang-ir-dominators.h"
+
+namespace Slang
+{
+    class BackEndCompileRequest;
+    struct IRGlobalValueWithCode;
+
+        /// Caches analyses of IR code, so that they are only computed again after a pass may have changed the IR.
+    struct IRAnalysisCache
+    {
+            /// Get the dominator tree for code, computing it if it isn't cached
+        IRDominatorTree* getDominatorTree(IRGlobalValueWithCode* code);
+
+            /// Remove all cached analyses. Must be called after anything that may change the IR.
+        void invalidate();
+
+    protected:
+        Dictionary<IRGlobalValueWithCode*, RefPtr<IRDominatorTree>> m_dominatorTrees;
+    };
+
+    /* Runs a sequence of passes over an IR module.
+
+    After each pass the module is validated (if validation is enabled), and any cached analyses are invalidated.
+
+    A pass can be run such that it's skipped when the module doesn't contain any instruction with the
+    ops the pass works on, as then it has nothing to do. Skipping a pass leaves the analyses valid.
+
+    If `-time-passes` is enabled, the wall time, the change in the amount of instructions and the memory arena
+    size after each pass is recorded, and written to the diagnostic sink when the manager is destroyed. */
+    class IRPassManager
+    {
+    public:
+            /// Run the pass func, which is named name
+        template <typename F>
+        void run(char const* name, F const& func)
+        {
+            _beginPass(name);
+            func();
+            _endPass();
+        }
+
+            /// Run the pass func, only if the module contains an instruction with one of the ops.
+        template <typename F>
+        void runIfModuleHasOps(char const* name, IROp const* ops, Index opCount, F const& func)
+        {
+            if (!_moduleHasOps(ops, opCount))
+            {
+                _skipPass(name);
+                return;
+            }
+            run(name, func);
+        }
+        template <typename F>
+        void runIfModuleHasOp(char const* name, IROp op, F const& func)
+        {
+            runIfModuleHasOps(name, &op, 1, func);
+        }
+
+            /// Set the module that passes are applied to. Can be set by a pass, for example by linking.
+        void setModule(IRModule* module);
+        IRModule* getModule() const { return m_module; }
+
+        IRAnalysisCache* getAnalysisCache() { return &m_analysisCache; }
+
+        IRPassManager(BackEndCompileRequest* compileRequest, IRModule* module = nullptr);
+        ~IRPassManager();
+
+    protected:
+        struct PassRecord
+        {
+            char const* name;
+            bool wasSkipped;
+            double seconds;
+            Index instCountBefore;
+            Index instCountAfter;
+            size_t arenaSizeInBytes;
+        };
+
+        void _beginPass(char const* name);
+        void _endPass();
+        void _skipPass(char const* name);
+
+        bool _moduleHasOps(IROp const* ops, Index opCount);
+            /// Recalculate the amount of instructions and which ops are used in the module
+        void _calcModuleOps();
+
+        void _writeReport();
+
+        BackEndCompileRequest* m_compileRequest;
+        IRModule* m_module = nullptr;
+
+        IRAnalysisCache m_analysisCache;
+
+        bool m_areModuleOpsValid = false;
+        UIntSet m_moduleOps;                    ///< The ops (without the 'other' bits) used in the module, if m_areModuleOpsValid
+        Index m_moduleInstCount = 0;            ///< The amount of instructions in the module, if m_areModuleOpsValid
+
+        bool m_shouldTimePasses = false;
+        List<PassRecord> m_passRecords;
+        uint64_t m_passStartTick = 0;
+    };
+}
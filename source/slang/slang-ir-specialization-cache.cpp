@@ -0,0 +1,112 @@
+// slang-ir-specialization-cache.cpp
+#include "slang-ir-specialization-cache.h"
+
+#include "slang-ir-specialize.h"
+
+namespace Slang
+{
+
+static Index _calcInstCountRec(IRInst* inst)
+{
+    Index count = 1;
+    for (auto child : inst->getDecorationsAndChildren())
+    {
+        count += _calcInstCountRec(child);
+    }
+    return count;
+}
+
+    /// Get the amount of instructions specializing generic clones
+static Index _calcSpecializationInstCount(IRGeneric* generic)
+{
+    Index count = 0;
+    for (auto inst : generic->getFirstBlock()->getOrdinaryInsts())
+    {
+        if (as<IRReturnVal>(inst))
+        {
+            break;
+        }
+        count += _calcInstCountRec(inst);
+    }
+    return count;
+}
+
+IRSpecializationCache::IRSpecializationCache(Session* session)
+{
+    m_sharedBuilder.session = session;
+    m_sharedBuilder.module = nullptr;
+
+    IRBuilder builder;
+    builder.sharedBuilder = &m_sharedBuilder;
+    m_module = builder.createModule();
+    m_sharedBuilder.module = m_module;
+}
+
+void IRSpecializationCache::_retainModule(IRInst* inst)
+{
+    if (!inst)
+    {
+        return;
+    }
+    IRModule* module = inst->getModule();
+    if (module && module != m_module && m_retainedModuleSet.Add(module))
+    {
+        m_retainedModules.add(module);
+    }
+}
+
+IRInst* IRSpecializationCache::getSpecialization(IRGeneric* generic, IRInst* const* args, Index argCount, Stats* ioStats)
+{
+    IRSimpleSpecializationKey key;
+    key.vals.add(generic);
+    key.vals.addRange(args, argCount);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Stats stats;
+    IRInst* value = nullptr;
+
+    if (Entry* entry = m_entries.TryGetValue(key))
+    {
+        stats.hitCount++;
+        stats.savedInstCount += entry->instCount;
+        value = entry->value;
+    }
+    else
+    {
+        // The specialized value refers to the generic's module and the modules of the args,
+        // so they must outlive it
+        _retainModule(generic);
+        for (Index i = 0; i < argCount; ++i)
+        {
+            _retainModule(args[i]);
+        }
+
+        IRBuilder builder;
+        builder.sharedBuilder = &m_sharedBuilder;
+        builder.setInsertInto(m_module->getModuleInst());
+
+        Entry newEntry;
+        newEntry.value = specializeGeneric(&builder, generic, args, argCount);
+        newEntry.instCount = _calcSpecializationInstCount(generic);
+        m_entries.Add(key, newEntry);
+
+        stats.missCount++;
+        value = newEntry.value;
+    }
+
+    m_stats.add(stats);
+    if (ioStats)
+    {
+        ioStats->add(stats);
+    }
+    return value;
+}
+
+IRSpecializationCache::Stats IRSpecializationCache::getStats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+}
@@ -0,0 +1,83 @@
+// slang-ir-specialization-cache.h
+#pragma once
+
+#include "../core/slang-basic.h"
+
+#include "slang-ir.h"
+#include "slang-ir-clone.h"
+#include "slang-ir-insts.h"
+
+#include <mutex>
+
+namespace Slang
+{
+
+/* A cache of specializations of generics, shared by all of the compilations in a session.
+
+Specializing a generic clones its body with its parameters replaced by the arguments. Without the cache that
+happens in every linked module, so compiling many entry points that use the same generics (like `Material<T>`
+with the same `T`) specializes them again for each entry point.
+
+An entry is keyed by the generic and the arguments, which are global values of the front-end IR modules (or
+values from this cache, for nested specializations). The entry holds the specialized value, in the cache's own
+IR module. The specialized value refers to the front-end IR directly, so the linker can clone it into a linked
+module just like front-end IR, which makes it independent of the target: anything it refers to that has
+target specific versions is resolved when it is linked.
+
+The cache keeps the IR modules of the generics and arguments alive, so that the entries stay valid. */
+class IRSpecializationCache : public RefObject
+{
+public:
+    typedef RefObject Super;
+
+    struct Stats
+    {
+        Index hitCount = 0;                 ///< Amount of specializations found in the cache
+        Index missCount = 0;                ///< Amount of specializations added to the cache
+        Index savedInstCount = 0;           ///< Amount of instructions the hits didn't have to create
+
+        void add(const Stats& rhs)
+        {
+            hitCount += rhs.hitCount;
+            missCount += rhs.missCount;
+            savedInstCount += rhs.savedInstCount;
+        }
+    };
+
+        /// Get the specialization of generic to args, specializing it if it isn't in the cache.
+        ///
+        /// The generic must be specializable (see `canSpecializeGeneric`). If ioStats is set, the
+        /// hit or miss is added to it as well as to the cache's stats. Can be called from multiple threads.
+    IRInst* getSpecialization(IRGeneric* generic, IRInst* const* args, Index argCount, Stats* ioStats);
+
+        /// True if inst is in the cache's module (such as a value returned from getSpecialization)
+    bool isCachedValue(IRInst* inst) const { return inst->getModule() == m_module; }
+
+        /// Get the stats since the cache was created
+    Stats getStats();
+
+    IRSpecializationCache(Session* session);
+
+protected:
+    struct Entry
+    {
+        IRInst* value;                      ///< The specialized value
+        Index instCount;                    ///< The amount of instructions created for the specialization
+    };
+
+    void _retainModule(IRInst* inst);
+
+    std::mutex m_mutex;                     ///< Guards everything below
+
+    RefPtr<IRModule> m_module;              ///< Holds the specialized values
+    SharedIRBuilder m_sharedBuilder;
+
+    Dictionary<IRSimpleSpecializationKey, Entry> m_entries;
+
+    HashSet<IRModule*> m_retainedModuleSet;
+    List<RefPtr<IRModule>> m_retainedModules;
+
+    Stats m_stats;
+};
+
+}
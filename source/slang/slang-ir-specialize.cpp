@@ -244,71 +244,10 @@ struct SpecializationContext
         return specializedVal;
     }
 
-    // The logic for generating a specialization of an IR generic
-    // relies on the ability to "evaluate" the code in the body of
-    // the generic, but that obviously doesn't work if we don't
-    // actually have the full definition for the body.
+    // Whether a generic is amenable to specialization is
+    // determined by `canSpecializeGeneric()`, which is defined
+    // at the end of this file so that the linker can use it too.
     //
-    // This can arise in particular for builtin operations/types.
-    //
-    // Before calling `specializeGeneric()` we need to make sure
-    // that the generic is actually amenable to specialization,
-    // by looking at whether it is a definition or a declaration.
-    //
-    bool canSpecializeGeneric(
-        IRGeneric*  generic)
-    {
-        // It is possible to have multiple "layers" of generics
-        // (e.g., when a generic function is nested in a generic
-        // type). Therefore we need to drill down through all
-        // of the layers present to see if at the leaf we have
-        // something that looks like a definition.
-        //
-        IRGeneric* g = generic;
-        for(;;)
-        {
-            // We can't specialize a generic if it is marked as
-            // being imported from an external module (in which
-            // case its definition is not available to us).
-            //
-            if(!isDefinition(g))
-                return false;
-
-            // Given the generic `g`, we will find the value
-            // it appears to return in its body.
-            //
-            auto val = findGenericReturnVal(g);
-            if(!val)
-                return false;
-
-            // If `g` returns an inner generic, then we need
-            // to drill down further.
-            //
-            if (auto nestedGeneric = as<IRGeneric>(val))
-            {
-                g = nestedGeneric;
-                continue;
-            }
-
-            // We should never specialize intrinsic types.
-            //
-            // TODO: This logic assumes that having *any* target
-            // intrinsic decoration makes a type skip specialization,
-            // even if the decoration isn't applicable to the
-            // current target. This should be made true in practice
-            // by having the linking step strip/skip decorations
-            // that aren't applicable to the chosen target at link time.
-            //
-            if(as<IRStructType>(val) && val->findDecoration<IRTargetIntrinsicDecoration>())
-                return false;
-
-            // Once we've found the leaf value that will be produced
-            // after all specialization is complete, we can check
-            // whether it looks like a definition or not.
-            //
-            return isDefinition(val);
-        }
-    }
 
     // Now that we know when we can specialize a generic, and how
     // to do it, we can write a subroutine that takes a
@@ -1808,18 +1747,92 @@ struct SpecializationContext
 };
 
 void specializeModule(
-    IRModule*   module)
+    IRModule*                                               module,
+    Dictionary<IRSimpleSpecializationKey, IRInst*> const*   genericSpecializations)
 {
     SpecializationContext context;
     context.module = module;
+    if (genericSpecializations)
+    {
+        context.genericSpecializations = *genericSpecializations;
+    }
     context.processModule();
 }
 
+// The logic for generating a specialization of an IR generic
+// relies on the ability to "evaluate" the code in the body of
+// the generic, but that obviously doesn't work if we don't
+// actually have the full definition for the body.
+//
+// This can arise in particular for builtin operations/types.
+//
+// Before calling `specializeGeneric()` we need to make sure
+// that the generic is actually amenable to specialization,
+// by looking at whether it is a definition or a declaration.
+//
+bool canSpecializeGeneric(
+    IRGeneric*  generic)
+{
+    // It is possible to have multiple "layers" of generics
+    // (e.g., when a generic function is nested in a generic
+    // type). Therefore we need to drill down through all
+    // of the layers present to see if at the leaf we have
+    // something that looks like a definition.
+    //
+    IRGeneric* g = generic;
+    for(;;)
+    {
+        // We can't specialize a generic if it is marked as
+        // being imported from an external module (in which
+        // case its definition is not available to us).
+        //
+        if(!isDefinition(g))
+            return false;
 
-IRInst* specializeGenericImpl(
+        // Given the generic `g`, we will find the value
+        // it appears to return in its body.
+        //
+        auto val = findGenericReturnVal(g);
+        if(!val)
+            return false;
+
+        // If `g` returns an inner generic, then we need
+        // to drill down further.
+        //
+        if (auto nestedGeneric = as<IRGeneric>(val))
+        {
+            g = nestedGeneric;
+            continue;
+        }
+
+        // We should never specialize intrinsic types.
+        //
+        // TODO: This logic assumes that having *any* target
+        // intrinsic decoration makes a type skip specialization,
+        // even if the decoration isn't applicable to the
+        // current target. This should be made true in practice
+        // by having the linking step strip/skip decorations
+        // that aren't applicable to the chosen target at link time.
+        //
+        if(as<IRStructType>(val) && val->findDecoration<IRTargetIntrinsicDecoration>())
+            return false;
+
+        // Once we've found the leaf value that will be produced
+        // after all specialization is complete, we can check
+        // whether it looks like a definition or not.
+        //
+        return isDefinition(val);
+    }
+}
+
+    /// Specialize `genericVal` to `args`, by cloning its body with `builder`.
+    ///
+    /// If `context` is set, the cloned instructions are added to its work list.
+static IRInst* _specializeGenericImpl(
     IRGeneric*              genericVal,
-    IRSpecialize*           specializeInst,
-    IRModule*               module,
+    IRInst* const*          args,
+    Index                   argCount,
+    IRBuilder*              builder,
     SpecializationContext*  context)
 {
     // Effectively, specializing a generic amounts to "calling" the generic
@@ -1846,30 +1859,18 @@ IRInst* specializeGenericImpl(
     // be initializing our environment to map `T -> a`, `U -> b`,
     // and `V -> c`.
     //
-    UInt argCounter = 0;
+    Index argCounter = 0;
     for( auto param : genericVal->getParams() )
     {
-        UInt argIndex = argCounter++;
-        SLANG_ASSERT(argIndex < specializeInst->getArgCount());
+        Index argIndex = argCounter++;
+        SLANG_ASSERT(argIndex < argCount);
+        SLANG_UNUSED(argCount);
 
-        IRInst* arg = specializeInst->getArg(argIndex);
+        IRInst* arg = args[argIndex];
 
         env.mapOldValToNew.Add(param, arg);
     }
 
-    // We will set up an IR builder for insertion
-    // into the global scope, at the same location
-    // as the original generic.
-    //
-    SharedIRBuilder sharedBuilderStorage;
-    sharedBuilderStorage.module = module;
-    sharedBuilderStorage.session = module->getSession();
-
-    IRBuilder builderStorage;
-    IRBuilder* builder = &builderStorage;
-    builder->sharedBuilder = &sharedBuilderStorage;
-    builder->setInsertBefore(genericVal);
-
     // Now we will run through the body of the generic and
     // clone each of its instructions into the global scope,
     // until we reach a `return` instruction.
@@ -1927,6 +1928,44 @@ IRInst* specializeGenericImpl(
     UNREACHABLE_RETURN(nullptr);
 }
 
+IRInst* specializeGenericImpl(
+    IRGeneric*              genericVal,
+    IRSpecialize*           specializeInst,
+    IRModule*               module,
+    SpecializationContext*  context)
+{
+    // We will set up an IR builder for insertion
+    // into the global scope, at the same location
+    // as the original generic.
+    //
+    SharedIRBuilder sharedBuilderStorage;
+    sharedBuilderStorage.module = module;
+    sharedBuilderStorage.session = module->getSession();
+
+    IRBuilder builderStorage;
+    IRBuilder* builder = &builderStorage;
+    builder->sharedBuilder = &sharedBuilderStorage;
+    builder->setInsertBefore(genericVal);
+
+    List<IRInst*> args;
+    UInt argCount = specializeInst->getArgCount();
+    for( UInt ii = 0; ii < argCount; ++ii )
+    {
+        args.add(specializeInst->getArg(ii));
+    }
+
+    return _specializeGenericImpl(genericVal, args.getBuffer(), args.getCount(), builder, context);
+}
+
+IRInst* specializeGeneric(
+    IRBuilder*      builder,
+    IRGeneric*      genericVal,
+    IRInst* const*  args,
+    Index           argCount)
+{
+    return _specializeGenericImpl(genericVal, args, argCount, builder, nullptr);
+}
+
 IRInst* specializeGeneric(
     IRSpecialize*   specializeInst)
 {
@@ -1,12 +1,33 @@
 // slang-ir-specialize.h
 #pragma once
 
+#include "slang-ir-clone.h"
+
 namespace Slang
 {
+struct IRBuilder;
+struct IRGeneric;
 struct IRModule;
 
     /// Specialize generic and interface-based code to use concrete types.
+    ///
+    /// If `genericSpecializations` is set, it holds specializations that have already
+    /// been made, from the generic and arguments to the specialized value.
 void specializeModule(
-    IRModule*   module);
+    IRModule*                                               module,
+    Dictionary<IRSimpleSpecializationKey, IRInst*> const*   genericSpecializations = nullptr);
+
+    /// Returns true if `generic` has a definition that can be specialized.
+bool canSpecializeGeneric(
+    IRGeneric*  generic);
+
+    /// Specialize `genericVal` to `args` by cloning its body with `builder`, and return the specialized value.
+    ///
+    /// Unlike `specializeModule` this doesn't specialize anything the body uses.
+IRInst* specializeGeneric(
+    IRBuilder*      builder,
+    IRGeneric*      genericVal,
+    IRInst* const*  args,
+    Index           argCount);
 
 }
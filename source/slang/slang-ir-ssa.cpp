@@ -27,7 +27,7 @@ struct PhiInfo : RefObject
     //
     // The order of elements in this list must match the
     // order in which the predecessor blocks get enumerated.
-    List<IRUse> operands;
+    List<IROutOfLineUse> operands;
 
     // If this phi ended up being removed as trivial, then
     // this will be the value that we replaced it with.
@@ -40,7 +40,7 @@ struct SSABlockInfo : RefObject
 {
     // Map a promotable variable to the value to
     // use for that variable
-    Dictionary<IRVar*, IRInst*> valueForVar;
+    FlatDictionary<IRVar*, IRInst*> valueForVar;
 
     // The underlying basic block.
     IRBlock* block;
@@ -472,7 +472,7 @@ IRInst* tryRemoveTrivialPhi(
     List<PhiInfo*> otherPhis;
     for( auto u = phi->firstUse; u; u = u->nextUse )
     {
-        auto user = u->user;
+        auto user = u->getUser();
         if(!user) continue;
         if(user == phi) continue;
 
@@ -3,6 +3,7 @@
 
 #include "slang-ir-dominators.h"
 #include "slang-ir-insts.h"
+#include "slang-ir-pass-manager.h"
 
 namespace Slang
 {
@@ -101,6 +102,10 @@ struct SynthesizeActiveMaskForModuleContext
     IRModule* m_module;
     DiagnosticSink* m_sink;
 
+    // If set, dominator trees are looked up in the cache.
+    //
+    IRAnalysisCache* m_analysisCache = nullptr;
+
     // We use a single shared IR builder for the entire pass, to
     // make sure we deduplicate types/values as much as possible.
     //
@@ -407,6 +412,7 @@ struct SynthesizeActiveMaskForFunctionContext
     //
     SharedIRBuilder* m_sharedBuilder;
     IRType* m_maskType;
+    IRAnalysisCache* m_analysisCache;
 
     void transformFunc()
     {
@@ -976,7 +982,10 @@ struct SynthesizeActiveMaskForFunctionContext
         // the function, since that will help us
         // identify the regions.
         //
-        m_dominatorTree = computeDominatorTree(m_func);
+        if (m_analysisCache)
+            m_dominatorTree = m_analysisCache->getDominatorTree(m_func);
+        else
+            m_dominatorTree = computeDominatorTree(m_func);
 
         // Next we look up th active mask for the function's
         // entry region, which had better be set before
@@ -2089,6 +2098,7 @@ void SynthesizeActiveMaskForModuleContext::transformFuncUsingActiveMask(IRFunc*
     context.m_func = func;
     context.m_sharedBuilder = &m_sharedBuilder;
     context.m_maskType = m_maskType;
+    context.m_analysisCache = m_analysisCache;
 
     context.transformFunc();
 }
@@ -2097,12 +2107,14 @@ void SynthesizeActiveMaskForModuleContext::transformFuncUsingActiveMask(IRFunc*
 // the context type for the module-level pass.
 //
 void synthesizeActiveMask(
-    IRModule*       module,
-    DiagnosticSink* sink)
+    IRModule*           module,
+    DiagnosticSink*     sink,
+    IRAnalysisCache*    analysisCache)
 {
     SynthesizeActiveMaskForModuleContext context;
     context.m_module = module;
     context.m_sink = sink;
+    context.m_analysisCache = analysisCache;
     context.processModule();
 }
 
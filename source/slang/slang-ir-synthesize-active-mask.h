@@ -7,6 +7,7 @@ namespace Slang
 class Session;
 struct IRModule;
 class DiagnosticSink;
+struct IRAnalysisCache;
 
     /// Synthesize values to represent the "active mask" for warp-/wave-level operations.
     ///
@@ -19,8 +20,11 @@ class DiagnosticSink;
     /// will instead be changed to compute the active mask to use as the first operation
     /// in their body.
     ///
+    /// If `analysisCache` is given, dominator trees are taken from it rather than computed.
+    ///
 void synthesizeActiveMask(
-    IRModule*       module,
-    DiagnosticSink* sink);
+    IRModule*           module,
+    DiagnosticSink*     sink,
+    IRAnalysisCache*    analysisCache = nullptr);
 
 }
@@ -94,14 +94,14 @@ namespace Slang
         if(!uv)
         {
             assert(!nextUse);
-            assert(!prevLink);
+            assert(!getPrevLink());
             return;
         }
 
         auto pp = &uv->firstUse;
         for(auto u = uv->firstUse; u;)
         {
-            assert(u->prevLink == pp);
+            assert(u->getPrevLink() == pp);
 
             pp = &u->nextUse;
             u = u->nextUse;
@@ -109,20 +109,43 @@ namespace Slang
 #endif
     }
 
-    void IRUse::init(IRInst* u, IRInst* v)
+    IRUse::Kind IRUse::_calcKind(IRInst* u)
     {
-        clear();
+        if (this == &u->typeUse)
+        {
+            return kKind_Type;
+        }
 
-        user = u;
+        IRUse* operands = u->getOperands();
+        const Index index = Index(this - operands);
+        SLANG_ASSERT(index >= 0 && index < Index(u->getOperandCount()));
+
+        const Index laterIndex = Index(kKind_LaterOperand - kKind_Operand0);
+        if (index < laterIndex)
+        {
+            return Kind(kKind_Operand0 + index);
+        }
+
+        // Finding the user requires stepping back to an operand that has its own kind,
+        // so make sure all of the operands before this have a kind if they were not initialized in order.
+        for (Index i = index - 1; i >= 0 && operands[i].getKind() == kKind_None; --i)
+        {
+            operands[i]._setKind((i < laterIndex) ? Kind(kKind_Operand0 + i) : kKind_LaterOperand);
+        }
+        return kKind_LaterOperand;
+    }
+
+    void IRUse::_link(IRInst* v)
+    {
         usedValue = v;
         if(v)
         {
             nextUse = v->firstUse;
-            prevLink = &v->firstUse;
+            setPrevLink(&v->firstUse);
 
             if(nextUse)
             {
-                nextUse->prevLink = &this->nextUse;
+                nextUse->setPrevLink(&this->nextUse);
             }
 
             v->firstUse = this;
@@ -131,9 +154,19 @@ namespace Slang
         debugValidate();
     }
 
+    void IRUse::init(IRInst* u, IRInst* v)
+    {
+        clear();
+
+        _setKind(u ? _calcKind(u) : kKind_None);
+        _link(v);
+    }
+
     void IRUse::set(IRInst* uv)
     {
-        init(user, uv);
+        // The user doesn't change, so neither does the kind
+        clear();
+        _link(uv);
     }
 
     void IRUse::clear()
@@ -146,23 +179,34 @@ namespace Slang
         if (usedValue)
         {
             auto uv = usedValue;
+            auto prevLink = getPrevLink();
 
             *prevLink = nextUse;
             if(nextUse)
             {
-                nextUse->prevLink = prevLink;
+                nextUse->setPrevLink(prevLink);
             }
 
-            user        = nullptr;
             usedValue   = nullptr;
             nextUse     = nullptr;
-            prevLink    = nullptr;
+            setPrevLink(nullptr);
 
             if(uv->firstUse)
                 uv->firstUse->debugValidate();
         }
     }
 
+    // IROutOfLineUse
+
+    void IROutOfLineUse::init(IRInst* u, IRInst* v)
+    {
+        use.clear();
+
+        user = u;
+        use._setKind(IRUse::kKind_OutOfLine);
+        use._link(v);
+    }
+
     // IRInstListBase
 
     void IRInstListBase::Iterator::operator++()
@@ -1353,6 +1397,12 @@ namespace Slang
 
             auto operandParent = operand->getParent();
 
+            // An operand at global scope doesn't constrain where the instruction goes.
+            // (The operand may even be in another module, when specializations are
+            // cached, see `IRSpecializationCache`.)
+            if (as<IRModuleInst>(operandParent))
+                continue;
+
             parent = mergeCandidateParentsForHoistableInst(parent, operandParent);
         }
 
@@ -2833,6 +2883,60 @@ namespace Slang
         return inst;
     }
 
+    IRModuleSymbolIndex::IRModuleSymbolIndex(IRModule* module)
+    {
+        for (auto inst : module->getGlobalInsts())
+        {
+            if (as<IRBindGlobalGenericParam>(inst))
+            {
+                m_globalGenericParamBindings.add(inst);
+            }
+            if (inst->findDecoration<IRPublicDecoration>())
+            {
+                m_publicValues.add(inst);
+            }
+
+            auto linkage = inst->findDecoration<IRLinkageDecoration>();
+            if (!linkage)
+                continue;
+
+            const UnownedStringSlice name = linkage->getMangledName();
+
+            Entry entry;
+            entry.inst = inst;
+            entry.nextWithSameName = -1;
+
+            const Index entryIndex = m_entries.getCount();
+            m_entries.add(entry);
+
+            // Entries with the same name are chained in module order, so we need to
+            // find the end of the chain
+            Index* firstEntryIndex = m_firstEntryForName.TryGetValueOrAdd(name, entryIndex);
+            if (firstEntryIndex)
+            {
+                Index lastEntryIndex = *firstEntryIndex;
+                while (m_entries[lastEntryIndex].nextWithSameName >= 0)
+                {
+                    lastEntryIndex = m_entries[lastEntryIndex].nextWithSameName;
+                }
+                m_entries[lastEntryIndex].nextWithSameName = entryIndex;
+            }
+            else if (as<IRWitnessTable>(inst))
+            {
+                m_witnessTableEntries.add(entryIndex);
+            }
+        }
+    }
+
+    IRModuleSymbolIndex* IRModule::getSymbolIndex()
+    {
+        if (!m_symbolIndex)
+        {
+            m_symbolIndex = new IRModuleSymbolIndex(this);
+        }
+        return m_symbolIndex;
+    }
+
     IRModule* IRBuilder::createModule()
     {
         auto module = new IRModule();
@@ -4732,6 +4836,54 @@ namespace Slang
         }
     }
 
+    void calcIRMemoryStats(IRModule* module, IRMemoryStats& outStats)
+    {
+        outStats = IRMemoryStats();
+
+        List<IRInst*> workList;
+        workList.add(module->getModuleInst());
+        while (workList.getCount())
+        {
+            IRInst* inst = workList.getLast();
+            workList.removeLast();
+
+            const UInt operandCount = inst->getOperandCount();
+            outStats.instCount++;
+            outStats.operandCount += Index(operandCount);
+            outStats.instSizeInBytes += sizeof(IRInst) + operandCount * sizeof(IRUse);
+
+            for (auto child : inst->getDecorationsAndChildren())
+            {
+                workList.add(child);
+            }
+        }
+
+        outStats.arenaSizeInBytes = module->memoryArena.calcTotalMemoryUsed();
+    }
+
+    void dumpIRMemoryReport(IRModule* module, ISlangWriter* slangWriter, char const* label)
+    {
+        IRMemoryStats stats;
+        calcIRMemoryStats(module, stats);
+
+        StringBuilder buf;
+        buf << "### IR MEMORY";
+        if (label)
+        {
+            buf << " (" << label << ")";
+        }
+        buf << ": " << stats.instCount << " instructions, " << stats.operandCount << " operands, ";
+        buf << UInt(stats.instSizeInBytes) << " bytes";
+        if (stats.instCount)
+        {
+            buf << " (" << UInt(stats.instSizeInBytes / stats.instCount) << " bytes/instruction)";
+        }
+        buf << ", arena " << UInt(stats.arenaSizeInBytes) << " bytes\n";
+
+        slangWriter->write(buf.getBuffer(), buf.getLength());
+        slangWriter->flush();
+    }
+
     String getSlangIRAssembly(IRModule* module, IRDumpMode mode)
     {
         StringBuilder sb;
@@ -5005,7 +5157,7 @@ namespace Slang
         if( auto nn = other->firstUse )
         {
             uu->nextUse = nn;
-            nn->prevLink = &uu->nextUse;
+            nn->setPrevLink(&uu->nextUse);
         }
 
         // No matter what, our list of
@@ -5013,7 +5165,7 @@ namespace Slang
         // of the list of uses for
         // `other`
         other->firstUse = ff;
-        ff->prevLink = &other->firstUse;
+        ff->setPrevLink(&other->firstUse);
 
         // And `this` will have no uses any more.
         this->firstUse = nullptr;
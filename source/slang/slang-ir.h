@@ -12,6 +12,7 @@
 #include "slang-source-loc.h"
 
 #include "../core/slang-memory-arena.h"
+#include "../core/slang-flat-dictionary.h"
 
 #include "slang-type-system-shared.h"
 
@@ -97,29 +98,103 @@ struct IROpInfo
 IROpInfo getIROpInfo(IROp op);
 
 // A use of another value/inst within an IR operation
+//
+// The instruction doing the using (the "user") is not stored in the use, as it can be found
+// from where the use is in memory. A use is either the `typeUse` of its user, one of the
+// operands stored after its user, or is held in an `IROutOfLineUse` that stores the user.
+// Which of these it is (the `Kind`) is stored in the low bits of the `prevLink` pointer,
+// saving a pointer on every use (including the `typeUse` of every instruction).
 struct IRUse
 {
+    enum Kind : UInt
+    {
+        kKind_None,                 ///< Not initialized with a user
+        kKind_Type,                 ///< The `typeUse` of the user
+        kKind_OutOfLine,            ///< Held in an `IROutOfLineUse`
+        kKind_Operand0,             ///< Operand 0 of the user. Operand n is kKind_Operand0 + n up to kKind_LaterOperand.
+        kKind_LaterOperand = 7,     ///< An operand after the ones with their own kind. The user is found by stepping back to one of those.
+
+        kKind_Mask = 7,
+    };
+
     IRInst* get() const { return usedValue; }
-    IRInst* getUser() const { return user; }
+    IRInst* getUser() const;
 
     void init(IRInst* user, IRInst* usedValue);
     void set(IRInst* usedValue);
     void clear();
 
+        /// Get the "link" back to where this use is referenced
+    IRUse** getPrevLink() const
+    {
+#if SLANG_PTR_IS_64
+        return (IRUse**)(m_prevLinkAndKind & ~UInt(kKind_Mask));
+#else
+        return m_prevLink;
+#endif
+    }
+    void setPrevLink(IRUse** prevLink)
+    {
+#if SLANG_PTR_IS_64
+        SLANG_ASSERT((UInt(prevLink) & kKind_Mask) == 0);
+        m_prevLinkAndKind = UInt(prevLink) | (m_prevLinkAndKind & kKind_Mask);
+#else
+        m_prevLink = prevLink;
+#endif
+    }
+
+    Kind getKind() const
+    {
+#if SLANG_PTR_IS_64
+        return Kind(m_prevLinkAndKind & kKind_Mask);
+#else
+        return m_kind;
+#endif
+    }
+
     // The instruction that is being used
     IRInst* usedValue = nullptr;
 
-    // The instruction that is doing the using.
-    IRInst* user = nullptr;
-
     // The next use of the same value
     IRUse*  nextUse = nullptr;
 
-    // A "link" back to where this use is referenced,
-    // so that we can simplify updates.
-    IRUse** prevLink = nullptr;
-
     void debugValidate();
+
+protected:
+    friend struct IROutOfLineUse;
+
+    void _setKind(Kind kind)
+    {
+#if SLANG_PTR_IS_64
+        m_prevLinkAndKind = (m_prevLinkAndKind & ~UInt(kKind_Mask)) | kind;
+#else
+        m_kind = kind;
+#endif
+    }
+    Kind _calcKind(IRInst* user);
+    void _link(IRInst* usedValue);
+
+#if SLANG_PTR_IS_64
+    // A "link" back to where this use is referenced, so that we can simplify updates.
+    // Pointers to the link are pointer aligned, so the low bits hold the Kind.
+    UInt m_prevLinkAndKind = 0;
+#else
+    // Pointers aren't aligned enough to hold the Kind in the low bits
+    IRUse** m_prevLink = nullptr;
+    Kind m_kind = kKind_None;
+#endif
+};
+
+    /// A use that isn't held in the instruction that is the user, so the user is stored with it.
+struct IROutOfLineUse
+{
+    IRInst* get() const { return use.get(); }
+
+    void init(IRInst* user, IRInst* usedValue);
+    void clear() { use.clear(); }
+
+    IRInst* user = nullptr;
+    IRUse use;
 };
 
 struct IRBlock;
@@ -457,7 +532,7 @@ struct IRInst
 
     void setOperand(UInt index, IRInst* value)
     {
-        SLANG_ASSERT(getOperands()[index].user != nullptr);
+        SLANG_ASSERT(getOperands()[index].getKind() != IRUse::kKind_None);
         getOperands()[index].set(value);
     }
 
@@ -528,6 +603,29 @@ struct IRInst
     void _insertAt(IRInst* inPrev, IRInst* inNext, IRInst* inParent);
 };
 
+inline IRInst* IRUse::getUser() const
+{
+    const IRUse* use = this;
+    Kind kind = use->getKind();
+    while (kind == kKind_LaterOperand)
+    {
+        use--;
+        kind = use->getKind();
+    }
+
+    switch (kind)
+    {
+        case kKind_None:        return nullptr;
+        case kKind_Type:        return (IRInst*)((char*)use - SLANG_OFFSET_OF(IRInst, typeUse));
+        case kKind_OutOfLine:   return ((IROutOfLineUse*)((char*)use - SLANG_OFFSET_OF(IROutOfLineUse, use)))->user;
+        default:
+        {
+            // The operands immediately follow the user
+            return ((IRInst*)(use - (kind - kKind_Operand0))) - 1;
+        }
+    }
+}
+
 template<typename T>
 T* dynamicCast(IRInst* inst)
 {
@@ -1389,6 +1487,48 @@ struct IRModuleInst : IRInst
     IR_LEAF_ISA(Module)
 };
 
+    /// An index of the global values in a module that have linkage, by their mangled name.
+    ///
+    /// It also records the other global instructions that linking needs to find,
+    /// so linking doesn't need to look at every instruction in the module.
+    ///
+    /// The names are slices of the mangled name strings held in the module, so the index
+    /// remains valid as long as the module is alive and isn't changed.
+struct IRModuleSymbolIndex : RefObject
+{
+    struct Entry
+    {
+        IRInst* inst;                       ///< The global value
+        Index nextWithSameName;             ///< Index of the next entry with the same name, or -1
+    };
+
+        /// Get the index of the first entry (in module order) named name, or -1 if there isn't one
+    Index findFirstEntry(const UnownedStringSlice& name) const
+    {
+        const Index* found = m_firstEntryForName.TryGetValue(name);
+        return found ? *found : -1;
+    }
+
+    const List<Entry>& getEntries() const { return m_entries; }
+        /// The entries for witness tables that are the first entry with their name
+    const List<Index>& getWitnessTableEntries() const { return m_witnessTableEntries; }
+
+        /// The global generic parameter bindings, in module order
+    const List<IRInst*>& getGlobalGenericParamBindings() const { return m_globalGenericParamBindings; }
+        /// The global values that have a public decoration, in module order
+    const List<IRInst*>& getPublicValues() const { return m_publicValues; }
+
+        /// Build the index for the global values of module
+    explicit IRModuleSymbolIndex(IRModule* module);
+
+protected:
+    FlatDictionary<UnownedStringSlice, Index> m_firstEntryForName;
+    List<Entry> m_entries;
+    List<Index> m_witnessTableEntries;
+    List<IRInst*> m_globalGenericParamBindings;
+    List<IRInst*> m_publicValues;
+};
+
 struct IRModule : RefObject
 {
     enum 
@@ -1401,6 +1541,13 @@ struct IRModule : RefObject
 
     IRInstListBase getGlobalInsts() const { return getModuleInst()->getChildren(); }
 
+        /// Get the index of global values with linkage. It is built on first use, and kept for the
+        /// lifetime of the module, so the module must not be changed after that.
+        ///
+        /// Building the index isn't thread safe, so when modules are linked on multiple threads
+        /// the index must be built up front.
+    IRModuleSymbolIndex* getSymbolIndex();
+
         /// Ctor
     IRModule():
         memoryArena(kMemoryArenaBlockSize)
@@ -1412,6 +1559,8 @@ struct IRModule : RefObject
     // The compilation session in use.
     Session*    session;
     IRModuleInst* moduleInst;
+
+    RefPtr<IRModuleSymbolIndex> m_symbolIndex;      ///< Built on first use by getSymbolIndex
 };
 
     /// How much detail to include in dumped IR.
@@ -1446,6 +1595,20 @@ void dumpIR(IRModule* module, ISlangWriter* writer, IRDumpMode mode = IRDumpMode
 void dumpIR(IRInst* globalVal, ISlangWriter* writer, IRDumpMode mode = IRDumpMode::Simplified);
 void dumpIR(IRModule* module, ISlangWriter* slangWriter, char const* label);
 
+    /// The memory used by the instructions in an IR module
+struct IRMemoryStats
+{
+    Index instCount = 0;                ///< Amount of instructions
+    Index operandCount = 0;             ///< Amount of operands (not including the type of each instruction)
+    size_t instSizeInBytes = 0;         ///< Size of the instructions and their operands (not including the values of constants)
+    size_t arenaSizeInBytes = 0;        ///< Total memory used by the module's arena, including instructions that have been removed
+};
+
+    /// Calculate the memory used by the instructions in module
+void calcIRMemoryStats(IRModule* module, IRMemoryStats& outStats);
+    /// Write a summary of the memory used by the instructions in module
+void dumpIRMemoryReport(IRModule* module, ISlangWriter* slangWriter, char const* label);
+
 IRInst* createEmptyInst(
     IRModule*   module,
     IROp        op,
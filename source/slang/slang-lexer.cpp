@@ -10,6 +10,17 @@
 
 #include <assert.h>
 
+#if SLANG_PROCESSOR_FAMILY_X86 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#   define SLANG_LEXER_SSE2 1
+#   include <emmintrin.h>
+#else
+#   define SLANG_LEXER_SSE2 0
+#endif
+
+#if SLANG_VC
+#   include <intrin.h>
+#endif
+
 namespace Slang
 {
     Token TokenReader::getEndOfFileToken()
@@ -96,6 +107,7 @@ namespace Slang
 
         m_tokenFlags = TokenFlag::AtStartOfLine | TokenFlag::AfterWhitespace;
         m_lexerFlags = 0;
+        m_hasDiagnostics = false;
     }
 
     Lexer::~Lexer()
@@ -235,6 +247,144 @@ namespace Slang
         }
     }
 
+    // Fast paths
+    //
+    // Most of the input is made of runs of bytes that the lexer just steps over
+    // (whitespace, the bodies of comments, identifiers, digits). Stepping over them
+    // with `_peek`/`_advance` is slow, as every byte is checked for an escaped newline.
+    //
+    // The `_skip` function instead finds the end of such a run directly from the raw
+    // bytes, 16 bytes at a time with SSE2 where available. A `CharSet` says which bytes
+    // are in a run. A backslash is never in a run, so the run always stops before a
+    // (possibly) escaped newline, and the lexer then carries on with `_peek`/`_advance`.
+    // As source locations are just offsets from the start of the input, the result is
+    // exactly the same as stepping over each byte.
+
+#if SLANG_LEXER_SSE2
+    typedef __m128i LexerBytes;
+
+    SLANG_FORCE_INLINE static LexerBytes _equals(LexerBytes bytes, char c)
+    {
+        return _mm_cmpeq_epi8(bytes, _mm_set1_epi8(c));
+    }
+
+        // Bytes in the range [lo, hi]. Adding 0x80 - lo makes the range start at the smallest
+        // signed value, so it can be tested with a single signed compare.
+    SLANG_FORCE_INLINE static LexerBytes _inRange(LexerBytes bytes, char lo, char hi)
+    {
+        const LexerBytes shifted = _mm_add_epi8(bytes, _mm_set1_epi8(char(0x80 - lo)));
+        return _mm_cmplt_epi8(shifted, _mm_set1_epi8(char(0x80 + (hi - lo) + 1)));
+    }
+#endif
+
+    struct HorizontalSpaceCharSet
+    {
+        static bool contains(char c) { return c == ' ' || c == '\t'; }
+#if SLANG_LEXER_SSE2
+        static LexerBytes contains(LexerBytes bytes)
+        {
+            return _mm_or_si128(_equals(bytes, ' '), _equals(bytes, '\t'));
+        }
+#endif
+    };
+
+    // The body of a line comment, up to the end of the line
+    struct LineCommentCharSet
+    {
+        static bool contains(char c) { return c != '\n' && c != '\r' && c != '\\'; }
+#if SLANG_LEXER_SSE2
+        static LexerBytes contains(LexerBytes bytes)
+        {
+            const LexerBytes stop = _mm_or_si128(_mm_or_si128(_equals(bytes, '\n'), _equals(bytes, '\r')), _equals(bytes, '\\'));
+            return _mm_andnot_si128(stop, _mm_set1_epi8(-1));
+        }
+#endif
+    };
+
+    // The body of a block comment, up to a `*` that may end it. Newlines are stepped
+    // over like any other byte inside a block comment, so they don't stop a run.
+    struct BlockCommentCharSet
+    {
+        static bool contains(char c) { return c != '*' && c != '\\'; }
+#if SLANG_LEXER_SSE2
+        static LexerBytes contains(LexerBytes bytes)
+        {
+            const LexerBytes stop = _mm_or_si128(_equals(bytes, '*'), _equals(bytes, '\\'));
+            return _mm_andnot_si128(stop, _mm_set1_epi8(-1));
+        }
+#endif
+    };
+
+    struct IdentifierCharSet
+    {
+        static bool contains(char c)
+        {
+            return ('a' <= c) && (c <= 'z')
+                || ('A' <= c) && (c <= 'Z')
+                || ('0' <= c) && (c <= '9')
+                || (c == '_');
+        }
+#if SLANG_LEXER_SSE2
+        static LexerBytes contains(LexerBytes bytes)
+        {
+            // Setting the 0x20 bit maps upper case letters to lower case (and nothing else onto letters)
+            const LexerBytes letters = _inRange(_mm_or_si128(bytes, _mm_set1_epi8(0x20)), 'a', 'z');
+            return _mm_or_si128(_mm_or_si128(letters, _inRange(bytes, '0', '9')), _equals(bytes, '_'));
+        }
+#endif
+    };
+
+    struct DecimalDigitCharSet
+    {
+        static bool contains(char c) { return ('0' <= c) && (c <= '9'); }
+#if SLANG_LEXER_SSE2
+        static LexerBytes contains(LexerBytes bytes) { return _inRange(bytes, '0', '9'); }
+#endif
+    };
+
+#if SLANG_LEXER_SSE2
+    SLANG_FORCE_INLINE static int _findFirstBit(uint32_t mask)
+    {
+#if SLANG_VC
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return int(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+#endif
+
+    // Returns the end of the run of bytes in CharSet starting at cursor
+    template <typename CharSet>
+    SLANG_FORCE_INLINE static char const* _skip(char const* cursor, char const* end)
+    {
+#if SLANG_LEXER_SSE2
+        // Only whole groups of 16 bytes are loaded, so nothing past the end is read
+        while (end - cursor >= 16)
+        {
+            const LexerBytes bytes = _mm_loadu_si128((const LexerBytes*)cursor);
+            const uint32_t stopMask = uint32_t(_mm_movemask_epi8(CharSet::contains(bytes))) ^ 0xffff;
+            if (stopMask)
+            {
+                return cursor + _findFirstBit(stopMask);
+            }
+            cursor += 16;
+        }
+#endif
+        while (cursor < end && CharSet::contains(*cursor))
+        {
+            cursor++;
+        }
+        return cursor;
+    }
+
+    template <typename CharSet>
+    SLANG_FORCE_INLINE static void _skip(Lexer* lexer)
+    {
+        lexer->m_cursor = _skip<CharSet>(lexer->m_cursor, lexer->m_end);
+    }
+
     static void _handleNewLine(Lexer* lexer)
     {
         int c = _advance(lexer);
@@ -245,6 +395,8 @@ namespace Slang
     {
         for(;;)
         {
+            _skip<LineCommentCharSet>(lexer);
+
             switch(_peek(lexer))
             {
             case '\n': case '\r': case kEOF:
@@ -261,6 +413,8 @@ namespace Slang
     {
         for(;;)
         {
+            _skip<BlockCommentCharSet>(lexer);
+
             switch(_peek(lexer))
             {
             case kEOF:
@@ -294,6 +448,8 @@ namespace Slang
     {
         for(;;)
         {
+            _skip<HorizontalSpaceCharSet>(lexer);
+
             switch(_peek(lexer))
             {
             case ' ': case '\t':
@@ -310,6 +466,8 @@ namespace Slang
     {
         for(;;)
         {
+            _skip<IdentifierCharSet>(lexer);
+
             int c = _peek(lexer);
             if(('a' <= c ) && (c <= 'z')
                 || ('A' <= c) && (c <= 'Z')
@@ -329,10 +487,23 @@ namespace Slang
         return lexer->m_startLoc + (lexer->m_cursor - lexer->m_begin);
     }
 
+    template <typename... Args>
+    static void _diagnose(Lexer* lexer, SourceLoc const& loc, DiagnosticInfo const& info, Args const&... args)
+    {
+        lexer->m_hasDiagnostics = true;
+        lexer->m_sink->diagnose(loc, info, args...);
+    }
+
     static void _lexDigits(Lexer* lexer, int base)
     {
         for(;;)
         {
+            // Decimal digits are all valid, so can be skipped without checking each one
+            if (base >= 10)
+            {
+                _skip<DecimalDigitCharSet>(lexer);
+            }
+
             int c = _peek(lexer);
 
             int digitVal = 0;
@@ -361,7 +532,7 @@ namespace Slang
             if(digitVal >= base)
             {
                 char buffer[] = { (char) c, 0 };
-                lexer->m_sink->diagnose(_getSourceLoc(lexer), Diagnostics::invalidDigitForBase, buffer, base);
+                _diagnose(lexer, _getSourceLoc(lexer), Diagnostics::invalidDigitForBase, buffer, base);
             }
 
             _advance(lexer);
@@ -376,6 +547,8 @@ namespace Slang
         //
         for( ;;)
         {
+            _skip<IdentifierCharSet>(lexer);
+
             int c = _peek(lexer);
 
             // Accept any alphanumeric character, plus underscores.
@@ -678,11 +851,11 @@ namespace Slang
             switch(c)
             {
             case kEOF:
-                lexer->m_sink->diagnose(_getSourceLoc(lexer), Diagnostics::endOfFileInLiteral);
+                _diagnose(lexer, _getSourceLoc(lexer), Diagnostics::endOfFileInLiteral);
                 return;
 
             case '\n': case '\r':
-                lexer->m_sink->diagnose(_getSourceLoc(lexer), Diagnostics::newlineInLiteral);
+                _diagnose(lexer, _getSourceLoc(lexer), Diagnostics::newlineInLiteral);
                 return;
 
             case '\\':
@@ -979,7 +1152,7 @@ namespace Slang
 
                 case '0': case '1': case '2': case '3': case '4':
                 case '5': case '6': case '7': case '8': case '9':
-                    lexer->m_sink->diagnose(loc, Diagnostics::octalLiteral);
+                    _diagnose(lexer, loc, Diagnostics::octalLiteral);
                     return _lexNumber(lexer, 8);
                 }
             }
@@ -1187,18 +1360,22 @@ namespace Slang
 
             auto loc = _getSourceLoc(lexer);
             int c = _advance(lexer);
+
+            // Recorded even if the diagnostic is ignored, as it wouldn't be if
+            // the same input was lexed without kLexerFlag_IgnoreInvalid
+            lexer->m_hasDiagnostics = true;
+
             if(!(effectiveFlags & kLexerFlag_IgnoreInvalid))
             {
-                auto sink = lexer->m_sink;
                 if(c >= 0x20 && c <=  0x7E)
                 {
                     char buffer[] = { (char) c, 0 };
-                    sink->diagnose(loc, Diagnostics::illegalCharacterPrint, buffer);
+                    _diagnose(lexer, loc, Diagnostics::illegalCharacterPrint, buffer);
                 }
                 else
                 {
                     // Fallback: print as hexadecimal
-                    sink->diagnose(loc, Diagnostics::illegalCharacterHex, String((unsigned char)c, 16));
+                    _diagnose(lexer, loc, Diagnostics::illegalCharacterHex, String((unsigned char)c, 16));
                 }
             }
 
@@ -125,6 +125,10 @@ namespace Slang
         TokenFlags      m_tokenFlags;
         LexerFlags      m_lexerFlags;
 
+            /// True if the lexer has written a diagnostic (or found an invalid character, even if
+            /// diagnosing it was suppressed by kLexerFlag_IgnoreInvalid)
+        bool            m_hasDiagnostics;
+
         MemoryArena*    m_memoryArena;
     };
 
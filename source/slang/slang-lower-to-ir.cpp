@@ -6163,7 +6163,7 @@ struct DeclLoweringVisitor : DeclVisitor<DeclLoweringVisitor, LoweredValInfo>
 
         if (auto semanticModifier = fieldDecl->findModifier<HLSLSimpleSemantic>())
         {
-            builder->addSemanticDecoration(irFieldKey, semanticModifier->name.getName()->text.getUnownedSlice());
+            builder->addSemanticDecoration(irFieldKey, semanticModifier->name.getName()->text);
         }
 
         // We allow a field to be marked as a target intrinsic,
@@ -7241,7 +7241,7 @@ static void lowerFrontEndEntryPointToIR(
 
     {
         Name* entryPointName = entryPoint->getFuncDecl()->getName();
-        builder->addEntryPointDecoration(instToDecorate, entryPoint->getProfile(), entryPointName->text.getUnownedSlice());
+        builder->addEntryPointDecoration(instToDecorate, entryPoint->getProfile(), entryPointName->text);
     }
 
     // Go through the entry point parameters creating decorations from layout as appropriate
@@ -7539,6 +7539,11 @@ IRModule* generateIRForTranslationUnit(
         DiagnosticSinkWriter writer(compileRequest->getSink());
         dumpIR(module, &writer, "LOWER-TO-IR");
     }
+    if (compileRequest->shouldReportIRMemory)
+    {
+        DiagnosticSinkWriter writer(compileRequest->getSink());
+        dumpIRMemoryReport(module, &writer, "LOWER-TO-IR");
+    }
 
     return module;
 }
@@ -1,6 +1,8 @@
 // slang-name.cpp
 #include "slang-name.h"
 
+#include <new>
+
 namespace Slang {
 
 String getText(Name* name)
@@ -11,32 +13,152 @@ String getText(Name* name)
 
 UnownedStringSlice getUnownedStringSliceText(Name* name)
 {
-    return name ? name->text.getUnownedSlice() : UnownedStringSlice();
+    return name ? name->text : UnownedStringSlice();
 }
 
 const char* getCstr(Name* name)
 {
-    return name ? name->text.getBuffer() : nullptr;
+    return name ? name->text.begin() : nullptr;
+}
+
+RootNamePool::RootNamePool()
+{
+    for (auto& shard : m_shards)
+    {
+        shard.arena.init(4096);
+    }
+}
+
+/* static */HashCode RootNamePool::calcHash(const UnownedStringSlice& text)
+{
+    // Names are mostly short identifiers, so hash a word at a time, and mix the
+    // (zero padded) remaining bytes in as a last word.
+    const uint64_t kMultiplier = 0x9e3779b97f4a7c15ull;
+
+    const char* cur = text.begin();
+    size_t remaining = size_t(text.getLength());
+
+    uint64_t hash = uint64_t(remaining) * kMultiplier;
+    while (remaining >= sizeof(uint64_t))
+    {
+        uint64_t word;
+        ::memcpy(&word, cur, sizeof(word));
+        hash = (hash ^ word) * kMultiplier;
+        hash ^= hash >> 29;
+
+        cur += sizeof(uint64_t);
+        remaining -= sizeof(uint64_t);
+    }
+    if (remaining)
+    {
+        uint64_t word = 0;
+        ::memcpy(&word, cur, remaining);
+        hash = (hash ^ word) * kMultiplier;
+    }
+
+    hash ^= hash >> 32;
+    hash *= kMultiplier;
+    hash ^= hash >> 29;
+    return getHashCode(hash);
+}
+
+/* static */Name** RootNamePool::_findSlot(Shard& shard, const UnownedStringSlice& text, HashCode hash)
+{
+    const Index mask = shard.slots.getCount() - 1;
+    Name** slots = shard.slots.getBuffer();
+
+    for (Index i = Index(hash) & mask; ; i = (i + 1) & mask)
+    {
+        Name* name = slots[i];
+        if (!name || (name->hash == hash && name->text == text))
+        {
+            return slots + i;
+        }
+    }
 }
 
-Name* NamePool::getName(String const& text)
+/* static */void RootNamePool::_grow(Shard& shard)
 {
-    RefPtr<Name> name;
-    if (rootPool->names.TryGetValue(text, name))
-        return name;
+    List<Name*> oldSlots;
+    oldSlots.swapWith(shard.slots);
 
-    name = new Name();
-    name->text = text;
-    rootPool->names.Add(text, name);
+    const Index newCount = oldSlots.getCount() ? oldSlots.getCount() * 2 : 64;
+    shard.slots.setCount(newCount);
+    ::memset(shard.slots.getBuffer(), 0, sizeof(Name*) * newCount);
+
+    // All the names are unique, so they just need to go in the first free slot
+    const Index mask = newCount - 1;
+    for (Name* name : oldSlots)
+    {
+        if (name)
+        {
+            Index i = Index(name->hash) & mask;
+            while (shard.slots[i])
+            {
+                i = (i + 1) & mask;
+            }
+            shard.slots[i] = name;
+        }
+    }
+}
+
+Name* RootNamePool::getName(const UnownedStringSlice& text)
+{
+    const HashCode hash = calcHash(text);
+    Shard& shard = m_shards[_getShardIndex(hash)];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Keep the load factor at most 1/2
+    if ((shard.nameCount + 1) * 2 > shard.slots.getCount())
+    {
+        _grow(shard);
+    }
+
+    Name** slot = _findSlot(shard, text, hash);
+    if (*slot)
+    {
+        return *slot;
+    }
+
+    // Allocate the name, followed by its text
+    const size_t length = size_t(text.getLength());
+    Name* name = (Name*)shard.arena.allocate(sizeof(Name) + length + 1);
+    char* chars = (char*)(name + 1);
+    ::memcpy(chars, text.begin(), length);
+    chars[length] = 0;
+
+    new (name) Name;
+    name->text = UnownedStringSlice(chars, length);
+    name->hash = hash;
+
+    *slot = name;
+    shard.nameCount++;
     return name;
 }
 
-Name* NamePool::tryGetName(String const& text)
+Name* RootNamePool::tryGetName(const UnownedStringSlice& text)
+{
+    const HashCode hash = calcHash(text);
+    Shard& shard = m_shards[_getShardIndex(hash)];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.nameCount == 0)
+    {
+        return nullptr;
+    }
+    return *_findSlot(shard, text, hash);
+}
+
+Index RootNamePool::getNameCount()
 {
-    RefPtr<Name> name;
-    if (rootPool->names.TryGetValue(text, name))
-        return name;
-    return nullptr;
+    Index count = 0;
+    for (auto& shard : m_shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.nameCount;
+    }
+    return count;
 }
 
 } // namespace Slang
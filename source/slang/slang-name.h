@@ -6,6 +6,9 @@
 // the name of types, variables, etc. in the AST.
 
 #include "../core/slang-basic.h"
+#include "../core/slang-memory-arena.h"
+
+#include <mutex>
 
 namespace Slang {
 
@@ -17,26 +20,32 @@ namespace Slang {
 // pointer to one and not deal with reference-counting overhead.
 //
 // In order to provide these benefits, a `Name` can only be created using
-// a `NamePool` that owns the allocations for all the names (so they get
+// a `RootNamePool` that owns the allocations for all the names (so they get
 // cleaned up when the pool is deleted), and which is responsible for
 // ensuring the uniqueness of name objects.
 //
-class Name : public RefObject
+class Name
 {
 public:
     // The raw text of the name.
     //
+    // The text is held by the pool that created the name, and is
+    // followed by a 0 byte, so can be used as a C style string.
+    //
     // Note that at some point in the future we might have other categories
     // of name than "simple" names, and so this might change to a structured
     // ADT instead of a simple string.
-    String text;
+    UnownedStringSlice text;
+
+    // The hash of the text (see `RootNamePool::calcHash`)
+    HashCode hash;
 };
 
 // Get the textual string representation of a name
 // (e.g., so that it can be printed).
 String getText(Name* name);
 
-/// Get the text as unowned string slice 
+/// Get the text as unowned string slice
 UnownedStringSlice getUnownedStringSliceText(Name* name);
 
 // Get a name as a C style string, or nullptr if name is nullptr
@@ -47,10 +56,58 @@ const char* getCstr(Name* name);
 // get equivalent names for a string like `"Foo"`, then they need to use
 // the same root name pool (directly or indirectly).
 //
+// The root name pool of a `Session` is shared by all of the compiles using it,
+// which may be on different threads. The names are split between shards by
+// their hash, each with its own lock, table and arena, so threads looking up
+// different names rarely wait for each other.
+//
 struct RootNamePool
 {
-    // The mapping from text strings to the corresponding name.
-    Dictionary<String, RefPtr<Name> > names;
+    // Find or create the `Name` that represents the given `text`.
+    Name* getName(const UnownedStringSlice& text);
+    // Try find the `Name` that represents the given `text`.
+    // If the name does not exist, return nullptr
+    Name* tryGetName(const UnownedStringSlice& text);
+
+    // Get the amount of names in the pool
+    Index getNameCount();
+
+    // Calculate the hash of the text of a name
+    static HashCode calcHash(const UnownedStringSlice& text);
+
+    RootNamePool();
+
+protected:
+    enum
+    {
+        kShardCountShift = 5,
+        kShardCount = 1 << kShardCountShift,
+    };
+
+    // Each shard holds the names whose hash selects it
+    struct Shard
+    {
+        // Guards everything below
+        std::mutex mutex;
+
+        // An open addressed hash table of the names, with linear probing.
+        // The size is a power of 2, and empty slots are nullptr.
+        List<Name*> slots;
+        Index nameCount = 0;
+
+        // Holds the names and their text
+        MemoryArena arena;
+    };
+
+    static Index _getShardIndex(HashCode hash) { return Index((UInt(hash) >> 7) & (kShardCount - 1)); }
+
+    // Find the slot holding the name for text (if there is one), or the empty slot it would go in
+    static Name** _findSlot(Shard& shard, const UnownedStringSlice& text, HashCode hash);
+
+    // Double the size of the shard's table
+    static void _grow(Shard& shard);
+
+    Shard m_shards[kShardCount];
 };
 
 // A `NamePool` is effectively a way of storing a subset of the
@@ -68,10 +125,13 @@ struct RootNamePool
 struct NamePool
 {
     // Find or create the `Name` that represents the given `text`.
-    Name* getName(String const& text);
+    Name* getName(const UnownedStringSlice& text) { return rootPool->getName(text); }
+    Name* getName(String const& text) { return rootPool->getName(text.getUnownedSlice()); }
+    Name* getName(char const* text) { return rootPool->getName(UnownedStringSlice(text)); }
     // Try find the `Name` that represents the given `text`.
     // If the name does not exist, return nullptr
-    Name* tryGetName(String const& text);
+    Name* tryGetName(const UnownedStringSlice& text) { return rootPool->tryGetName(text); }
+    Name* tryGetName(String const& text) { return rootPool->tryGetName(text.getUnownedSlice()); }
     // Set the parent name pool to use for lookup
     void setRootNamePool(RootNamePool* rootNamePool)
     {
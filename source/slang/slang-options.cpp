@@ -16,6 +16,7 @@
 #include "slang-ir-serialize.h"
 
 #include "../core/slang-type-text-util.h"
+#include "../core/slang-string-util.h"
 
 #include <assert.h>
 
@@ -23,6 +24,24 @@ namespace Slang {
 
 SlangResult _addLibraryReference(EndToEndCompileRequest* req, Stream* stream);
 
+// Append data as C source defining a static const array called `name` holding it
+static void _appendBinaryAsCSource(const char* name, const void* data, size_t size, StringBuilder& out)
+{
+    out << "// Generated by slang. Do not edit.\n\n";
+    out << "static const unsigned char " << name << "[] = \n{";
+
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; ++i)
+    {
+        if ((i & 31) == 0)
+        {
+            out << "\n    ";
+        }
+        StringUtil::appendFormat(out, "%u,", unsigned(bytes[i]));
+    }
+    out << "\n};\n";
+}
+
 SlangResult tryReadCommandLineArgumentRaw(DiagnosticSink* sink, char const* option, char const* const**ioCursor, char const* const*end, char const** argOut)
 {
     *argOut = nullptr;
@@ -47,6 +66,26 @@ SlangResult tryReadCommandLineArgument(DiagnosticSink* sink, char const* option,
     return SLANG_OK;
 }
 
+SlangResult tryReadCommandLineUnsignedIntArgument(DiagnosticSink* sink, char const* option, char const* const**ioCursor, char const* const*end, Int& outValue)
+{
+    String text;
+    SLANG_RETURN_ON_FAIL(tryReadCommandLineArgument(sink, option, ioCursor, end, text));
+
+    bool isValid = text.getLength() > 0 && text.getLength() < 10;
+    for (auto c : text)
+    {
+        isValid = isValid && (c >= '0' && c <= '9');
+    }
+    if (!isValid)
+    {
+        sink->diagnose(SourceLoc(), Diagnostics::expectedIntegerArgumentForOption, option, text);
+        return SLANG_FAIL;
+    }
+
+    outValue = StringToInt(text);
+    return SLANG_OK;
+}
+
 struct OptionsParser
 {
     SlangSession*           session = nullptr;
@@ -435,6 +474,10 @@ struct OptionsParser
 
         bool hasLoadedRepro = false;
 
+        // The cache is set up after all the options are parsed, so the size can be specified before or after the directory
+        String downstreamCompileCacheDirectory;
+        Int downstreamCompileCacheSizeInMB = 0;
+
         char const* const* argCursor = &argv[0];
         char const* const* argEnd = &argv[argc];
         while (argCursor != argEnd)
@@ -467,6 +510,23 @@ struct OptionsParser
                     requestImpl->getFrontEndReq()->shouldDumpIR = true;
                     requestImpl->getBackEndReq()->shouldDumpIR = true;
                 }
+                else if (argStr == "-report-ir-memory")
+                {
+                    requestImpl->getFrontEndReq()->shouldReportIRMemory = true;
+                    requestImpl->getBackEndReq()->shouldReportIRMemory = true;
+                }
+                else if (argStr == "-time-passes")
+                {
+                    requestImpl->getBackEndReq()->shouldTimePasses = true;
+                }
+                else if (argStr == "-report-specialization-cache")
+                {
+                    requestImpl->getBackEndReq()->shouldReportSpecializationCache = true;
+                }
+                else if (argStr == "-report-skipped-includes")
+                {
+                    requestImpl->getFrontEndReq()->shouldReportSkippedIncludes = true;
+                }
                 else if (argStr == "-dump-ast")
                 {
                     requestImpl->getFrontEndReq()->shouldDumpAST = true;
@@ -555,6 +615,27 @@ struct OptionsParser
                     // Set as the file system
                     spSetFileSystem(compileRequest, cacheFileSystem);
                 }
+                else if (argStr == "-save-stdlib" || argStr == "-save-stdlib-bin-source")
+                {
+                    String fileName;
+                    SLANG_RETURN_ON_FAIL(tryReadCommandLineArgument(sink, arg, &argCursor, argEnd, fileName));
+
+                    ComPtr<ISlangBlob> stdLibBlob;
+                    SLANG_RETURN_ON_FAIL(session->saveStdLib(stdLibBlob.writeRef()));
+
+                    if (argStr == "-save-stdlib")
+                    {
+                        SLANG_RETURN_ON_FAIL(File::writeAllBytes(fileName, stdLibBlob->getBufferPointer(), stdLibBlob->getBufferSize()));
+                    }
+                    else
+                    {
+                        // Write out as C++ source, such that it can be embedded in the slang library
+                        // (see SLANG_EMBED_STDLIB)
+                        StringBuilder builder;
+                        _appendBinaryAsCSource("g_embeddedStdLib", stdLibBlob->getBufferPointer(), stdLibBlob->getBufferSize(), builder);
+                        SLANG_RETURN_ON_FAIL(File::writeAllBytes(fileName, builder.getBuffer(), builder.getLength()));
+                    }
+                }
                 else if (argStr == "-serial-ir")
                 {
                     requestImpl->getFrontEndReq()->useSerialIRBottleneck = true;
@@ -802,6 +883,52 @@ struct OptionsParser
                     spSetLineDirectiveMode(compileRequest, mode);
 
                 }
+                else if (argStr == "-backend-threads")
+                {
+                    Int count;
+                    SLANG_RETURN_ON_FAIL(tryReadCommandLineUnsignedIntArgument(sink, arg, &argCursor, argEnd, count));
+                    spSetBackEndThreadCount(compileRequest, int(count));
+                }
+                else if (argStr == "-permutation")
+                {
+                    // The definitions are a comma separated list, as in:
+                    //     -permutation USE_FOG,QUALITY=2
+                    String definesText;
+                    SLANG_RETURN_ON_FAIL(tryReadCommandLineArgument(sink, arg, &argCursor, argEnd, definesText));
+
+                    const int permutationIndex = spAddPermutation(compileRequest);
+
+                    List<UnownedStringSlice> defines;
+                    StringUtil::split(definesText.getUnownedSlice(), ',', defines);
+                    for (const auto& define : defines)
+                    {
+                        if (define.getLength() == 0)
+                        {
+                            continue;
+                        }
+                        const Index eqIndex = define.indexOf('=');
+                        if (eqIndex >= 0)
+                        {
+                            spPermutation_addPreprocessorDefine(
+                                compileRequest,
+                                permutationIndex,
+                                String(UnownedStringSlice(define.begin(), define.begin() + eqIndex)).getBuffer(),
+                                String(UnownedStringSlice(define.begin() + eqIndex + 1, define.end())).getBuffer());
+                        }
+                        else
+                        {
+                            spPermutation_addPreprocessorDefine(compileRequest, permutationIndex, String(define).getBuffer(), "");
+                        }
+                    }
+                }
+                else if (argStr == "-downstream-cache")
+                {
+                    SLANG_RETURN_ON_FAIL(tryReadCommandLineArgument(sink, arg, &argCursor, argEnd, downstreamCompileCacheDirectory));
+                }
+                else if (argStr == "-downstream-cache-size")
+                {
+                    SLANG_RETURN_ON_FAIL(tryReadCommandLineUnsignedIntArgument(sink, arg, &argCursor, argEnd, downstreamCompileCacheSizeInMB));
+                }
                 else if( argStr == "-fp-mode" || argStr == "-floating-point-mode" )
                 {
                     String name;
@@ -990,6 +1117,16 @@ struct OptionsParser
             }
         }
 
+        if (downstreamCompileCacheDirectory.getLength())
+        {
+            const SlangInt sizeInBytes = SlangInt(downstreamCompileCacheSizeInMB) * 1024 * 1024;
+            if (SLANG_FAILED(session->setDownstreamCompileCache(downstreamCompileCacheDirectory.getBuffer(), sizeInBytes)))
+            {
+                sink->diagnose(SourceLoc(), Diagnostics::unableToUseDownstreamCompileCache, downstreamCompileCacheDirectory);
+                return SLANG_FAIL;
+            }
+        }
+
         // TODO(JS): This is a restriction because of how setting of state works for load repro
         // If a repro has been loaded, then many of the following options will overwrite
         // what was set up. So for now they are ignored, and only parameters set as part
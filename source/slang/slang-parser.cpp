@@ -2989,6 +2989,12 @@ namespace Slang
         return (NodeBase*)syntaxClass.createInstanceImpl(parser->astBuilder);
     }
 
+    void setSimpleSyntaxParseCallback(SyntaxDecl* syntaxDecl)
+    {
+        syntaxDecl->parseCallback = &parseSimpleSyntax;
+        syntaxDecl->parseUserData = (void*) syntaxDecl->syntaxClass.classInfo;
+    }
+
     // Parse a declaration of a keyword that can be used to define further syntax.
     static NodeBase* parseSyntaxDecl(Parser* parser, void* /*userData*/)
     {
@@ -26,6 +26,12 @@ namespace Slang
     ModuleDecl* populateBaseLanguageModule(
         ASTBuilder*     astBuilder,
         RefPtr<Scope>   scope);
+
+        /// Restore the parse callback of a `SyntaxDecl` that was not created by the parser
+        /// (for example one that has been deserialized).
+        ///
+        /// Only syntax that simply constructs an instance of its `syntaxClass` can be restored.
+    void setSimpleSyntaxParseCallback(SyntaxDecl* syntaxDecl);
 }
 
 #endif
@@ -4,6 +4,7 @@
 #include "slang-compiler.h"
 #include "slang-diagnostics.h"
 #include "slang-lexer.h"
+#include "slang-token-cache.h"
 // Needed so that we can construct modifier syntax to represent GLSL directives
 #include "slang-syntax.h"
 
@@ -97,6 +98,23 @@ struct PreprocessorInputStream
     virtual ~PreprocessorInputStream() = default;
 };
 
+// Tracks whether a file has the include guard idiom:
+//
+//     #ifndef NAME
+//     ...
+//     #endif
+//
+// with nothing but whitespace and comments outside of the conditional. If it
+// does, including the file again while `NAME` is defined would produce nothing,
+// so the include can be skipped without reading the file again.
+enum class IncludeGuardState
+{
+    Start,          // Nothing has been seen yet
+    InGuard,        // Inside the `#ifndef` that may be the include guard
+    AfterGuard,     // After the `#endif` of the include guard
+    NotGuarded,     // The file doesn't have an include guard
+};
+
 // A "primary" input stream represents the top-level context of a file
 // being parsed, and tracks things like preprocessor conditional state
 struct PrimaryInputStream : PreprocessorInputStream
@@ -107,11 +125,27 @@ struct PrimaryInputStream : PreprocessorInputStream
     // The deepest preprocessor conditional active for this stream.
     PreprocessorConditional*        conditional;
 
+    // Whether the file has an include guard, as far as has been seen
+    IncludeGuardState               includeGuardState;
+
+    // The name tested by the include guard, and the conditional it opened
+    Name*                           includeGuardName;
+    PreprocessorConditional*        includeGuardConditional;
+
     // The lexer state that will provide input
     Lexer lexer;
 
     // One token of lookahead
     Token token;
+
+    // If set, the tokens are replayed from an earlier lexing of the same file
+    // (until a token is needed with different lexer flags), and `token` is the
+    // token at `replayTokenIndex`.
+    RefPtr<CachedTokenList>         replayTokens;
+    Index                           replayTokenIndex;
+
+    // If set, the tokens that are lexed are recorded, to add them to the token cache
+    RefPtr<CachedTokenList>         recordTokens;
 };
 
 // A "secondary" input stream represents code that is being expanded
@@ -227,6 +261,15 @@ struct Preprocessor
     // stop them from being included again.
     HashSet<String>                         pragmaOnceUniqueIdentities;
 
+    // The unique identities of files that have an include guard, mapped to the name the guard tests.
+    // Such a file doesn't need to be included again while the name is defined.
+    Dictionary<String, Name*>               includeGuardNames;
+
+    PreprocessorStats                       stats;
+
+    // Cache of the tokens of files, or nullptr if files are always lexed
+    TokenCache*                             tokenCache = nullptr;
+
     NamePool* getNamePool() { return linkage->getNamePool(); }
     SourceManager* getSourceManager() { return linkage->getSourceManager(); }
 };
@@ -264,6 +307,10 @@ static void initializePrimaryInputStream(Preprocessor* preprocessor, PrimaryInpu
     initializeInputStream(preprocessor, inputStream);
     inputStream->primaryStream = inputStream;
     inputStream->conditional = NULL;
+    inputStream->includeGuardState = IncludeGuardState::Start;
+    inputStream->includeGuardName = nullptr;
+    inputStream->includeGuardConditional = nullptr;
+    inputStream->replayTokenIndex = -1;
 }
 
 // Destroy an input stream
@@ -272,6 +319,50 @@ static void destroyInputStream(Preprocessor* /*preprocessor*/, PreprocessorInput
     delete inputStream;
 }
 
+// Read the next token of a primary stream into its lookahead `token`
+static void readPrimaryToken(PrimaryInputStream* inputStream, LexerFlags lexerFlags)
+{
+    Lexer& lexer = inputStream->lexer;
+
+    if (auto replayTokens = inputStream->replayTokens)
+    {
+        const Index index = inputStream->replayTokenIndex;
+
+        // Once at the end of the file, it stays there
+        if (index >= 0 && inputStream->token.type == TokenType::EndOfFile)
+        {
+            return;
+        }
+
+        // Replay the next token if it was lexed with the same flags (kLexerFlag_IgnoreInvalid
+        // doesn't matter, as only files without invalid characters are cached)
+        const auto& nextInfo = replayTokens->getTokenInfo(index + 1);
+        if ((lexerFlags & ~kLexerFlag_IgnoreInvalid) == nextInfo.extraFlags)
+        {
+            inputStream->token = replayTokens->getToken(index + 1, lexer.m_startLoc);
+            inputStream->replayTokenIndex = index + 1;
+            return;
+        }
+
+        // Otherwise lex the rest of the file, starting from where the lexer was after the current token
+        if (index >= 0)
+        {
+            const auto& info = replayTokens->getTokenInfo(index);
+            lexer.m_cursor = lexer.m_begin + info.endOffset;
+            lexer.m_lexerFlags = info.lexerFlagsAfter;
+            lexer.m_tokenFlags = 0;
+        }
+        inputStream->replayTokens = nullptr;
+    }
+
+    inputStream->token = lexer.lexToken(lexerFlags);
+
+    if (auto recordTokens = inputStream->recordTokens)
+    {
+        recordTokens->addToken(inputStream->token, &lexer, lexerFlags);
+    }
+}
+
 // Create an input stream to represent a pre-tokenized input file.
 // TODO(tfoley): pre-tokenizing files isn't going to work in the long run.
 static PreprocessorInputStream* CreateInputStreamForSource(
@@ -285,7 +376,19 @@ static PreprocessorInputStream* CreateInputStreamForSource(
 
     // initialize the embedded lexer so that it can generate a token stream
     inputStream->lexer.initialize(sourceView, GetSink(preprocessor), preprocessor->getNamePool(), memoryArena);
-    inputStream->token = inputStream->lexer.lexToken();
+
+    // Replay the tokens of the file if it has been lexed before, otherwise record them
+    if (auto tokenCache = preprocessor->tokenCache)
+    {
+        SourceFile* sourceFile = sourceView->getSourceFile();
+        inputStream->replayTokens = tokenCache->find(sourceFile);
+        if (!inputStream->replayTokens)
+        {
+            inputStream->recordTokens = new CachedTokenList(sourceFile, sourceView->getRange().begin);
+        }
+    }
+
+    readPrimaryToken(inputStream, 0);
 
     return inputStream;
 }
@@ -327,6 +430,27 @@ static void EndInputStream(Preprocessor* preprocessor, PreprocessorInputStream*
                 conditional = parent;
             }
         }
+        // Otherwise, if the whole file was inside an include guard, remember it
+        // so the file can be skipped if it is included again.
+        else if (primaryStream->includeGuardState == IncludeGuardState::AfterGuard)
+        {
+            auto sourceFile = primaryStream->lexer.m_sourceView->getSourceFile();
+            const PathInfo& pathInfo = sourceFile->getPathInfo();
+            if (pathInfo.hasUniqueIdentity())
+            {
+                preprocessor->includeGuardNames[pathInfo.uniqueIdentity] = primaryStream->includeGuardName;
+            }
+        }
+
+        // If all of the tokens of the file were recorded, and lexing them didn't
+        // produce any diagnostics, they can be replayed next time.
+        auto recordTokens = primaryStream->recordTokens;
+        if (recordTokens && recordTokens->getTokenCount() &&
+            primaryStream->token.type == TokenType::EndOfFile &&
+            !primaryStream->lexer.m_hasDiagnostics)
+        {
+            preprocessor->tokenCache->add(primaryStream->lexer.m_sourceView->getSourceFile(), recordTokens);
+        }
     }
 
     destroyInputStream(preprocessor, inputStream);
@@ -338,7 +462,7 @@ static Token AdvanceRawToken(PreprocessorInputStream* inputStream, LexerFlags le
     if( auto primaryStream = asPrimaryInputStream(inputStream) )
     {
         auto result = primaryStream->token;
-        primaryStream->token = primaryStream->lexer.lexToken(lexerFlags);
+        readPrimaryToken(primaryStream, lexerFlags);
         return result;
     }
     else
@@ -413,18 +537,17 @@ static Token AdvanceRawToken(Preprocessor* preprocessor, LexerFlags lexerFlags =
     }
 }
 
-// Return the next token in "raw" mode, but don't advance the
-// current token state.
-static Token PeekRawToken(Preprocessor* preprocessor)
+// Find the stream that `AdvanceRawToken` would read the next token from,
+// or nullptr if there is no more input.
+static PreprocessorInputStream* findPeekInputStream(Preprocessor* preprocessor)
 {
-    // We need to find the stream that `advanceRawToken` would read from.
     PreprocessorInputStream* inputStream = preprocessor->inputStream;
     for (;;)
     {
         if (!inputStream)
         {
             // No more input streams left to read
-            return preprocessor->endOfFileToken;
+            return nullptr;
         }
 
         // The top-most input stream may be at its end, so
@@ -439,11 +562,22 @@ static Token PeekRawToken(Preprocessor* preprocessor)
             }
         }
 
-        // Everything worked, so the token we just peeked is fine.
-        return PeekRawToken(inputStream);
+        return inputStream;
     }
 }
 
+// Return the next token in "raw" mode, but don't advance the
+// current token state.
+static Token PeekRawToken(Preprocessor* preprocessor)
+{
+    PreprocessorInputStream* inputStream = findPeekInputStream(preprocessor);
+    if (!inputStream)
+    {
+        return preprocessor->endOfFileToken;
+    }
+    return PeekRawToken(inputStream);
+}
+
 // Get the location of the current (raw) token
 static SourceLoc PeekLoc(Preprocessor* preprocessor)
 {
@@ -1636,6 +1770,15 @@ static void HandleIfNDefDirective(PreprocessorDirectiveContext* context)
 
     // Check if the name is defined.
     beginConditional(context, LookupMacro(context, name) == NULL);
+
+    // If this is the first thing in the file, it may be an include guard
+    auto primaryStream = context->preprocessor->inputStream->primaryStream;
+    if (primaryStream->includeGuardState == IncludeGuardState::Start)
+    {
+        primaryStream->includeGuardState = IncludeGuardState::InGuard;
+        primaryStream->includeGuardName = name;
+        primaryStream->includeGuardConditional = primaryStream->conditional;
+    }
 }
 
 // Handle a `#else` directive
@@ -1661,6 +1804,12 @@ static void HandleElseDirective(PreprocessorDirectiveContext* context)
     }
     conditional->elseToken = context->directiveToken;
 
+    // An include guard can't have another branch
+    if (conditional == inputStream->primaryStream->includeGuardConditional)
+    {
+        inputStream->primaryStream->includeGuardState = IncludeGuardState::NotGuarded;
+    }
+
     switch (conditional->state)
     {
     case PreprocessorConditionalState::Before:
@@ -1714,6 +1863,12 @@ static void HandleElifDirective(PreprocessorDirectiveContext* context)
         return;
     }
 
+    // An include guard can't have another branch
+    if (conditional == inputStream->primaryStream->includeGuardConditional)
+    {
+        inputStream->primaryStream->includeGuardState = IncludeGuardState::NotGuarded;
+    }
+
     switch (conditional->state)
     {
     case PreprocessorConditionalState::Before:
@@ -1744,7 +1899,18 @@ static void HandleEndIfDirective(PreprocessorDirectiveContext* context)
         return;
     }
 
-    inputStream->primaryStream->conditional = conditional->parent;
+    // If this ends the include guard, the rest of the file must be empty for it to be one
+    auto primaryStream = inputStream->primaryStream;
+    if (conditional == primaryStream->includeGuardConditional)
+    {
+        if (primaryStream->includeGuardState == IncludeGuardState::InGuard)
+        {
+            primaryStream->includeGuardState = IncludeGuardState::AfterGuard;
+        }
+        primaryStream->includeGuardConditional = nullptr;
+    }
+
+    primaryStream->conditional = conditional->parent;
     DestroyConditional(conditional);
 }
 
@@ -1849,9 +2015,21 @@ static void HandleIncludeDirective(PreprocessorDirectiveContext* context)
     // Check whether we've previously included this file and seen a `#pragma once` directive
     if(context->preprocessor->pragmaOnceUniqueIdentities.Contains(filePathInfo.uniqueIdentity))
     {
+        context->preprocessor->stats.pragmaOnceSkippedIncludeCount++;
         return;
     }
 
+    // Check whether we've previously included this file and it has an include guard that is
+    // still defined, in which case including it again would produce nothing
+    if (Name** guardName = context->preprocessor->includeGuardNames.TryGetValue(filePathInfo.uniqueIdentity))
+    {
+        if (LookupMacro(&context->preprocessor->globalEnv, *guardName))
+        {
+            context->preprocessor->stats.includeGuardSkippedIncludeCount++;
+            return;
+        }
+    }
+
     // Simplify the path
     filePathInfo.foundPath = includeHandler->simplifyPath(filePathInfo.foundPath);
 
@@ -2276,6 +2454,29 @@ static void HandleDirective(PreprocessorDirectiveContext* context)
     // Look up the handler for the directive.
     PreprocessorDirective const* directive = FindDirective(GetDirectiveName(context));
 
+    // Any directive other than the `#ifndef` that starts an include guard (and the
+    // directives inside it) means the file doesn't have an include guard. The
+    // include guard directives themselves update the state when they are handled.
+    {
+        auto primaryStream = context->preprocessor->inputStream->primaryStream;
+        switch (primaryStream->includeGuardState)
+        {
+        case IncludeGuardState::Start:
+            if (directive->callback != &HandleIfNDefDirective)
+            {
+                primaryStream->includeGuardState = IncludeGuardState::NotGuarded;
+            }
+            break;
+
+        case IncludeGuardState::AfterGuard:
+            primaryStream->includeGuardState = IncludeGuardState::NotGuarded;
+            break;
+
+        default:
+            break;
+        }
+    }
+
     // If we are skipping disabled code, and the directive is not one
     // of the small number that need to run even in that case, skip it.
     if (IsSkipping(context) && !(directive->flags & PreprocessorDirectiveFlag::ProcessWhenSkipping))
@@ -2316,7 +2517,8 @@ static Token ReadToken(Preprocessor* preprocessor)
         }
 
         // Look at the next raw token in the input.
-        Token const& token = PeekRawToken(preprocessor);
+        PreprocessorInputStream* inputStream = findPeekInputStream(preprocessor);
+        Token const& token = inputStream ? PeekRawToken(inputStream) : preprocessor->endOfFileToken;
         if (token.type == TokenType::EndOfFile)
             return token;
 
@@ -2337,6 +2539,12 @@ static Token ReadToken(Preprocessor* preprocessor)
             continue;
         }
 
+        // A token outside of the include guard means the guard doesn't cover the whole file
+        if (inputStream->primaryStream->includeGuardState != IncludeGuardState::InGuard)
+        {
+            inputStream->primaryStream->includeGuardState = IncludeGuardState::NotGuarded;
+        }
+
         // otherwise, if we are currently in a skipping mode, then skip tokens
         if (IsSkipping(preprocessor))
         {
@@ -2454,12 +2662,14 @@ TokenList preprocessSource(
     IncludeHandler*             includeHandler,
     Dictionary<String, String>  defines,
     Linkage*                    linkage,
-    Module*                     parentModule)
+    Module*                     parentModule,
+    PreprocessorStats*          outStats)
 {
     Preprocessor preprocessor;
     InitializePreprocessor(&preprocessor, sink);
     preprocessor.linkage = linkage;
     preprocessor.parentModule = parentModule;
+    preprocessor.tokenCache = linkage->getTokenCache();
 
     preprocessor.includeHandler = includeHandler;
     for (auto p : defines)
@@ -2478,6 +2688,11 @@ TokenList preprocessSource(
 
     FinalizePreprocessor(&preprocessor);
 
+    if (outStats)
+    {
+        *outStats = preprocessor.stats;
+    }
+
     // debugging: build the pre-processed source back together
 #if 0
     StringBuilder sb;
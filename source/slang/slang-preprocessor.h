@@ -24,14 +24,23 @@ struct IncludeHandler
     virtual String simplifyPath(const String& path) = 0;
 };
 
+    /// Counts of what the preprocessor did
+struct PreprocessorStats
+{
+    Index includeGuardSkippedIncludeCount = 0;      ///< `#include`s skipped as the file's include guard was defined
+    Index pragmaOnceSkippedIncludeCount = 0;        ///< `#include`s skipped as the file had `#pragma once`
+};
+
 // Take a string of source code and preprocess it into a list of tokens.
+// If outStats is set, it is set to the counts for preprocessing the source.
 TokenList preprocessSource(
     SourceFile*                 file,
     DiagnosticSink*             sink,
     IncludeHandler*             includeHandler,
     Dictionary<String, String>  defines,
     Linkage*                    linkage,
-    Module*                     parentModule);
+    Module*                     parentModule,
+    PreprocessorStats*          outStats = nullptr);
 
 } // namespace Slang
 
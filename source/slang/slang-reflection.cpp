@@ -136,7 +136,7 @@ SLANG_API char const* spReflectionUserAttribute_GetName(SlangReflectionUserAttri
 {
     auto userAttr = convert(attrib);
     if (!userAttr) return nullptr;
-    return userAttr->getName()->text.getBuffer();
+    return userAttr->getName()->text.begin();
 }
 SLANG_API unsigned int spReflectionUserAttribute_GetArgumentCount(SlangReflectionUserAttribute* attrib)
 {
@@ -1377,7 +1377,7 @@ SLANG_API char const* spReflectionTypeParameter_GetName(SlangReflectionTypeParam
     auto specializationParam = convert(inTypeParam);
     if( auto genericParamLayout = as<GenericSpecializationParamLayout>(specializationParam) )
     {
-        return genericParamLayout->decl->getName()->text.getBuffer();
+        return genericParamLayout->decl->getName()->text.begin();
     }
     // TODO: Add case for existential type parameter? They don't have as simple of a notion of "name" as the generic case...
     return nullptr;
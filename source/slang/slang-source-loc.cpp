@@ -198,15 +198,23 @@ PathInfo SourceView::getPathInfo(SourceLoc loc, SourceLocType type)
 
 void SourceFile::setLineBreakOffsets(const uint32_t* offsets, UInt numOffsets)
 {
+    std::lock_guard<std::mutex> lock(m_lineBreakOffsetsMutex);
     m_lineBreakOffsets.clear();
     m_lineBreakOffsets.addRange(offsets, numOffsets);
+    m_hasLineBreakOffsets.store(numOffsets > 0, std::memory_order_release);
 }
 
 const List<uint32_t>& SourceFile::getLineBreakOffsets()
 {
+    if (m_hasLineBreakOffsets.load(std::memory_order_acquire))
+    {
+        return m_lineBreakOffsets;
+    }
+
     // We now have a raw input file that we can search for line breaks.
     // We obviously don't want to do a linear scan over and over, so we will
     // cache an array of line break locations in the file.
+    std::lock_guard<std::mutex> lock(m_lineBreakOffsetsMutex);
     if (m_lineBreakOffsets.getCount() == 0)
     {
         UnownedStringSlice content(getContent()), line;
@@ -220,6 +228,7 @@ const List<uint32_t>& SourceFile::getLineBreakOffsets()
         // "end of file inside string literal" with a line number
         // that points at a line that doesn't exist.
     }
+    m_hasLineBreakOffsets.store(true, std::memory_order_release);
 
     return m_lineBreakOffsets;
 }
@@ -284,7 +293,8 @@ void SourceFile::setContents(const String& content)
 SourceFile::SourceFile(SourceManager* sourceManager, const PathInfo& pathInfo, size_t contentSize) :
     m_sourceManager(sourceManager),
     m_pathInfo(pathInfo),
-    m_contentSize(contentSize)
+    m_contentSize(contentSize),
+    m_hasLineBreakOffsets(false)
 {
 }
 
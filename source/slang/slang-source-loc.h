@@ -9,6 +9,9 @@
 #include "../../slang-com-ptr.h"
 #include "../../slang.h"
 
+#include <atomic>
+#include <mutex>
+
 namespace Slang {
 
 /** Overview: 
@@ -208,8 +211,12 @@ public:
 
     // In order to speed up lookup of line number information,
     // we will cache the starting offset of each line break in
-    // the input file:
+    // the input file. They are calculated on demand, which can
+    // happen on multiple threads (such as when generating code
+    // for several requests in parallel):
     List<uint32_t> m_lineBreakOffsets;
+    std::atomic<bool> m_hasLineBreakOffsets;
+    std::mutex m_lineBreakOffsetsMutex;
 };
 
 enum class SourceLocType
@@ -0,0 +1,95 @@
+// slang-token-cache.cpp
+#include "slang-token-cache.h"
+
+namespace Slang
+{
+
+// CachedTokenList
+
+CachedTokenList::CachedTokenList(SourceFile* sourceFile, SourceLoc startLoc):
+    m_contentBlob(sourceFile->getContentBlob()),
+    m_content(sourceFile->getContent()),
+    m_startLoc(startLoc)
+{
+}
+
+void CachedTokenList::addToken(const Token& token, Lexer* lexer, LexerFlags extraFlags)
+{
+    TokenInfo info;
+    info.endOffset = uint32_t(lexer->m_cursor - lexer->m_begin);
+    info.extraFlags = extraFlags & ~kLexerFlag_IgnoreInvalid;
+    info.lexerFlagsAfter = lexer->m_lexerFlags;
+
+    m_tokens.add(token);
+    m_tokenInfos.add(info);
+}
+
+// TokenCache
+
+TokenCache::TokenCache():
+    m_arena(4096)
+{
+}
+
+RefPtr<CachedTokenList> TokenCache::find(SourceFile* sourceFile)
+{
+    const PathInfo& pathInfo = sourceFile->getPathInfo();
+    if (!pathInfo.hasUniqueIdentity() || !sourceFile->getContentBlob())
+    {
+        return nullptr;
+    }
+
+    const UnownedStringSlice content = sourceFile->getContent();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    RefPtr<CachedTokenList> tokens;
+    if (m_entries.TryGetValue(pathInfo.uniqueIdentity, tokens))
+    {
+        // Content in the same blob must be the same. Otherwise the hash is checked first,
+        // so usually only content that is the same is compared.
+        const UnownedStringSlice& cachedContent = tokens->m_content;
+        const bool isSame = (cachedContent.begin() == content.begin() && cachedContent.getLength() == content.getLength()) ||
+            (tokens->m_contentHash == getHashCode64(content.begin(), content.getLength()) && cachedContent == content);
+        if (isSame)
+        {
+            return tokens;
+        }
+    }
+
+    return nullptr;
+}
+
+void TokenCache::add(SourceFile* sourceFile, CachedTokenList* tokens)
+{
+    const PathInfo& pathInfo = sourceFile->getPathInfo();
+    if (!pathInfo.hasUniqueIdentity() || !tokens->m_contentBlob)
+    {
+        return;
+    }
+
+    const UnownedStringSlice content = tokens->m_content;
+    tokens->m_contentHash = getHashCode64(content.begin(), content.getLength());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // The text of a token that had escaped newlines removed is held by the memory arena the
+    // lexer was using, which may not live as long as the cache, so it's copied.
+    for (auto& token : tokens->m_tokens)
+    {
+        if (token.flags & TokenFlag::Name)
+        {
+            continue;
+        }
+        const UnownedStringSlice text = token.getContent();
+        if (text.getLength() && (text.begin() < content.begin() || text.end() > content.end()))
+        {
+            const char* copy = m_arena.allocateString(text.begin(), text.getLength());
+            token.setContent(UnownedStringSlice(copy, text.getLength()));
+        }
+    }
+
+    m_entries[pathInfo.uniqueIdentity] = tokens;
+}
+
+}
@@ -0,0 +1,93 @@
+// slang-token-cache.h
+#ifndef SLANG_TOKEN_CACHE_H
+#define SLANG_TOKEN_CACHE_H
+
+#include "../core/slang-basic.h"
+#include "../core/slang-memory-arena.h"
+
+#include "slang-lexer.h"
+#include "slang-source-loc.h"
+
+#include <mutex>
+
+namespace Slang
+{
+
+/* The tokens lexed from a source file, such that they can be replayed instead of lexing the file again.
+
+The tokens are the ones a Lexer produces for the file, with the extra flags the preprocessor lexed each one with.
+If the preprocessor asks for a token with different flags the recording can't be used from that token on, so for
+each token the position and lexer state after it is recorded too, which is enough to carry on lexing from there.
+
+The locations of the tokens are in the source view the file was lexed in. They must be rebased onto the view
+they are replayed in (see `getToken`). */
+class CachedTokenList : public RefObject
+{
+public:
+    struct TokenInfo
+    {
+        uint32_t endOffset;             ///< Offset from the start of the file to the end of the token's text
+        LexerFlags extraFlags;          ///< The extra flags the token was lexed with (without kLexerFlag_IgnoreInvalid)
+        LexerFlags lexerFlagsAfter;     ///< The lexer's flags after lexing the token
+    };
+
+        /// Get the token at index, with its location in the view starting at startLoc
+    Token getToken(Index index, SourceLoc startLoc) const
+    {
+        Token token = m_tokens[index];
+        token.loc = startLoc + (Int(token.loc.getRaw()) - Int(m_startLoc.getRaw()));
+        return token;
+    }
+    const TokenInfo& getTokenInfo(Index index) const { return m_tokenInfos[index]; }
+    Index getTokenCount() const { return m_tokens.getCount(); }
+
+        /// Add the token last lexed by lexer, which was lexed with extraFlags
+    void addToken(const Token& token, Lexer* lexer, LexerFlags extraFlags);
+
+        /// Start recording the tokens lexed from sourceFile, in a view starting at startLoc
+    CachedTokenList(SourceFile* sourceFile, SourceLoc startLoc);
+
+protected:
+    friend class TokenCache;
+
+    ComPtr<ISlangBlob> m_contentBlob;       ///< Holds the content the tokens refer to
+    UnownedStringSlice m_content;
+    HashCode64 m_contentHash = 0;
+
+    SourceLoc m_startLoc;
+    List<Token> m_tokens;
+    List<TokenInfo> m_tokenInfos;
+};
+
+/* A cache of the tokens lexed from source files, so that a file that is included or imported again doesn't
+need to be lexed again.
+
+Entries are keyed by the unique identity of the file, and are only used if the content is the same (which is
+checked with a hash of the content, if it isn't from the same blob). Only files that lex without any diagnostics
+are added, so replaying the tokens never needs to reproduce any.
+
+The tokens hold names from a NamePool, so a cache must only be used with that pool. Can be used from multiple
+threads. */
+class TokenCache : public RefObject
+{
+public:
+        /// Find the tokens for the content of sourceFile, or nullptr if they aren't cached
+    RefPtr<CachedTokenList> find(SourceFile* sourceFile);
+
+        /// Add the recorded tokens for a file, replacing any previous entry for its unique identity
+    void add(SourceFile* sourceFile, CachedTokenList* tokens);
+
+    TokenCache();
+
+protected:
+    std::mutex m_mutex;                 ///< Guards everything below
+
+    Dictionary<String, RefPtr<CachedTokenList>> m_entries;
+
+        /// Holds token text that isn't in the file's content (tokens that needed escaped newlines removed)
+    MemoryArena m_arena;
+};
+
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include "../core/slang-io.h"
 #include "../core/slang-string-util.h"
 #include "../core/slang-shared-library.h"
+#include "../core/slang-parallel-util.h"
 
 #include "slang-check.h"
 #include "slang-parameter-binding.h"
@@ -26,12 +27,25 @@
 #include "slang-source-loc.h"
 
 #include "slang-ir-serialize.h"
+#include "slang-ir-specialization-cache.h"
+#include "slang-token-cache.h"
 
 #include "slang-check-impl.h"
+#include "slang-lookup.h"
+
+#include "../core/slang-blob.h"
+#include "../core/slang-riff.h"
+
+#if SLANG_EMBED_STDLIB
+// Holds the serialized stdlib (in `g_embeddedStdLib`), as produced by `slangc -save-stdlib-bin-source`
+#include "slang-stdlib-generated.h"
+#endif
 
 // Used to print exception type names in internal-compiler-error messages
 #include <typeinfo>
 
+#include <exception>
+
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
@@ -121,6 +135,8 @@ void Session::init()
     // Set all the shared library function pointers to nullptr
     ::memset(m_sharedLibraryFunctions, 0, sizeof(m_sharedLibraryFunctions));
 
+    m_irSpecializationCache = new IRSpecializationCache(this);
+
     // Set up shared AST builder
     m_sharedASTBuilder = new SharedASTBuilder;
     m_sharedASTBuilder->init(this);
@@ -171,9 +187,6 @@ void Session::init()
     slangLanguageScope = new Scope();
     slangLanguageScope->nextSibling = hlslLanguageScope;
 
-    addBuiltinSource(coreLanguageScope, "core", getCoreLibraryCode());
-    addBuiltinSource(hlslLanguageScope, "hlsl", getHLSLLibraryCode());
-
     {
         for (Index i = 0; i < Index(SourceLanguage::CountOf); ++i)
         {
@@ -209,6 +222,10 @@ SLANG_NO_THROW SlangResult SLANG_MCALL Session::createSession(
     {
         linkage->m_useFalcorCustomSharedKeywordSemantics = true;
     }
+    if(desc.flags & slang::kSessionFlag_ReloadChangedModules)
+    {
+        linkage->m_reloadChangedModules = true;
+    }
 
     linkage->setMatrixLayoutMode(desc.defaultMatrixLayoutMode);
 
@@ -547,6 +564,8 @@ Linkage::Linkage(Session* session, ASTBuilder* astBuilder)
 
     m_defaultSourceManager.initialize(session->getBuiltinSourceManager(), nullptr);
 
+    m_tokenCache = new TokenCache();
+
     setFileSystem(nullptr);
 }
 
@@ -614,8 +633,21 @@ SLANG_NO_THROW slang::IModule* SLANG_MCALL Linkage::loadModule(
 {
     auto name = getNamePool()->getName(moduleName);
 
+    removeChangedModules();
+
     DiagnosticSink sink(getSourceManager());
-    auto module = findOrImportModule(name, SourceLoc(), &sink);
+
+    RefPtr<Module> module;
+    try
+    {
+        module = findOrImportModule(name, SourceLoc(), &sink);
+    }
+    catch (const AbortCompilationException&)
+    {
+        // An error in the module is reported as a fatal error, which aborts the load.
+        // The diagnostic has already been produced.
+        module.setNull();
+    }
     sink.getBlobIfNeeded(outDiagnostics);
 
     return asExternal(module);
@@ -716,6 +748,8 @@ SLANG_NO_THROW slang::TypeLayoutReflection* SLANG_MCALL Linkage::getTypeLayout(
 SLANG_NO_THROW SlangResult SLANG_MCALL Linkage::createCompileRequest(
     SlangCompileRequest**   outCompileRequest)
 {
+    removeChangedModules();
+
     auto compileRequest = new EndToEndCompileRequest(this);
     *outCompileRequest = asExternal(compileRequest);
     return SLANG_OK;
@@ -1002,13 +1036,15 @@ void FrontEndCompileRequest::parseTranslationUnit(
         break;
     }
 
+    // The more specific definitions replace the more general ones, so a permutation
+    // can redefine a macro defined for the whole linkage
     Dictionary<String, String> combinedPreprocessorDefinitions;
     for(auto& def : getLinkage()->preprocessorDefinitions)
-        combinedPreprocessorDefinitions.Add(def.Key, def.Value);
+        combinedPreprocessorDefinitions[def.Key] = def.Value;
     for(auto& def : preprocessorDefinitions)
-        combinedPreprocessorDefinitions.Add(def.Key, def.Value);
+        combinedPreprocessorDefinitions[def.Key] = def.Value;
     for(auto& def : translationUnit->preprocessorDefinitions)
-        combinedPreprocessorDefinitions.Add(def.Key, def.Value);
+        combinedPreprocessorDefinitions[def.Key] = def.Value;
 
     auto module = translationUnit->getModule();
 
@@ -1042,13 +1078,26 @@ void FrontEndCompileRequest::parseTranslationUnit(
 
     for (auto sourceFile : translationUnit->getSourceFiles())
     {
+        PreprocessorStats preprocessorStats;
         auto tokens = preprocessSource(
             sourceFile,
             getSink(),
             &includeHandler,
             combinedPreprocessorDefinitions,
             getLinkage(),
-            module);
+            module,
+            &preprocessorStats);
+
+        if (shouldReportSkippedIncludes)
+        {
+            StringBuilder buf;
+            buf << "### SKIPPED INCLUDES: " << sourceFile->getPathInfo().foundPath << ": ";
+            buf << preprocessorStats.includeGuardSkippedIncludeCount << " by include guards, ";
+            buf << preprocessorStats.pragmaOnceSkippedIncludeCount << " by #pragma once\n";
+
+            DiagnosticSinkWriter writer(getSink());
+            writer.write(buf.getBuffer(), buf.getLength());
+        }
 
         parseSourceFile(
             astBuilder,
@@ -1275,6 +1324,13 @@ BackEndCompileRequest::BackEndCompileRequest(
     , m_dumpIntermediatePrefix("slang-dump-")
 {}
 
+RefPtr<BackEndCompileRequest> BackEndCompileRequest::cloneWithSink(DiagnosticSink* sink)
+{
+    RefPtr<BackEndCompileRequest> request = new BackEndCompileRequest(*this);
+    request->setSink(sink);
+    return request;
+}
+
 EndToEndCompileRequest::EndToEndCompileRequest(
     Session* session)
     : m_session(session)
@@ -1335,6 +1391,30 @@ SlangResult EndToEndCompileRequest::executeActionsInner()
         }
     }
 
+    if (permutations.getCount())
+    {
+        return _executePermutations();
+    }
+
+    bool isComplete = false;
+    SLANG_RETURN_ON_FAIL(_executeActionsBeforeCodeGen(isComplete));
+    if (isComplete)
+    {
+        return SLANG_OK;
+    }
+
+    // Generate output code, in whatever format was requested
+    generateOutput(this);
+    if (getSink()->getErrorCount() != 0)
+        return SLANG_FAIL;
+
+    return SLANG_OK;
+}
+
+SlangResult EndToEndCompileRequest::_executeActionsBeforeCodeGen(bool& outIsComplete)
+{
+    outIsComplete = false;
+
     // We only do parsing and semantic checking if we *aren't* doing
     // a pass-through compilation.
     //
@@ -1360,6 +1440,7 @@ SlangResult EndToEndCompileRequest::executeActionsInner()
         SLANG_RETURN_ON_FAIL(maybeCreateContainer());
         SLANG_RETURN_ON_FAIL(maybeWriteContainer(m_containerOutputPath));
 
+        outIsComplete = true;
         return SLANG_OK;
     }
 
@@ -1416,15 +1497,186 @@ SlangResult EndToEndCompileRequest::executeActionsInner()
         m_specializedEntryPoints = getFrontEndReq()->getUnspecializedEntryPoints();
     }
 
-    // Generate output code, in whatever format was requested
     getBackEndReq()->setProgram(getSpecializedGlobalAndEntryPointsComponentType());
-    generateOutput(this);
-    if (getSink()->getErrorCount() != 0)
-        return SLANG_FAIL;
-
     return SLANG_OK;
 }
 
+Index EndToEndCompileRequest::addPermutation()
+{
+    permutations.add(Permutation());
+    return permutations.getCount() - 1;
+}
+
+static String _getPermutationOutputPath(String const& path, Index permutationIndex)
+{
+    // The index goes before the extension, so `a.spv` becomes `a.0.spv`
+    if (path.getLength() == 0)
+    {
+        return path;
+    }
+    StringBuilder buf;
+    buf << Path::getPathWithoutExt(path) << "." << permutationIndex;
+    const String ext = Path::getPathExt(path);
+    if (ext.getLength())
+    {
+        buf << "." << ext;
+    }
+    return buf.ProduceString();
+}
+
+RefPtr<EndToEndCompileRequest> EndToEndCompileRequest::_createPermutationRequest(Index permutationIndex)
+{
+    RefPtr<EndToEndCompileRequest> request = new EndToEndCompileRequest(getLinkage());
+
+    // Diagnostics are buffered (the sink has no writer), and reported through this request in order
+    request->m_sink.setFlags(m_sink.getFlags());
+    request->setWriter(WriterChannel::StdOutput, getWriter(WriterChannel::StdOutput));
+    request->setWriter(WriterChannel::StdError, getWriter(WriterChannel::StdError));
+
+    request->passThrough = passThrough;
+    request->globalSpecializationArgStrings = globalSpecializationArgStrings;
+    request->shouldSkipCodegen = shouldSkipCodegen;
+    request->entryPoints = entryPoints;
+    request->m_containerFormat = m_containerFormat;
+    request->m_containerOutputPath = _getPermutationOutputPath(m_containerOutputPath, permutationIndex);
+    for (const auto& pair : targetInfos)
+    {
+        RefPtr<TargetInfo> targetInfo = new TargetInfo;
+        targetInfo->wholeTargetOutputPath = _getPermutationOutputPath(pair.Value->wholeTargetOutputPath, permutationIndex);
+        for (const auto& entryPointPair : pair.Value->entryPointOutputPaths)
+        {
+            targetInfo->entryPointOutputPaths.Add(entryPointPair.Key, _getPermutationOutputPath(entryPointPair.Value, permutationIndex));
+        }
+        request->targetInfos.Add(pair.Key, targetInfo);
+    }
+
+    // The back end options are all copied. Code for the permutations is generated in parallel,
+    // so each permutation generates its own code serially.
+    request->m_backEndReq = getBackEndReq()->cloneWithSink(request->getSink());
+    request->m_backEndReq->setProgram(nullptr);
+    request->m_backEndReq->backEndThreadCount = 1;
+
+    auto frontEndReq = getFrontEndReq();
+    auto dstFrontEndReq = request->getFrontEndReq();
+
+    dstFrontEndReq->shouldDumpIR = frontEndReq->shouldDumpIR;
+    dstFrontEndReq->shouldValidateIR = frontEndReq->shouldValidateIR;
+    dstFrontEndReq->shouldReportIRMemory = frontEndReq->shouldReportIRMemory;
+    dstFrontEndReq->shouldTimePasses = frontEndReq->shouldTimePasses;
+    dstFrontEndReq->shouldReportSpecializationCache = frontEndReq->shouldReportSpecializationCache;
+    dstFrontEndReq->shouldReportSkippedIncludes = frontEndReq->shouldReportSkippedIncludes;
+    dstFrontEndReq->shouldDumpAST = frontEndReq->shouldDumpAST;
+
+    dstFrontEndReq->compileFlags = frontEndReq->compileFlags;
+    dstFrontEndReq->useSerialIRBottleneck = frontEndReq->useSerialIRBottleneck;
+    dstFrontEndReq->verifyDebugSerialization = frontEndReq->verifyDebugSerialization;
+    dstFrontEndReq->searchDirectories = frontEndReq->searchDirectories;
+    dstFrontEndReq->m_defaultModuleName = frontEndReq->m_defaultModuleName;
+    dstFrontEndReq->m_extraEntryPoints = frontEndReq->m_extraEntryPoints;
+
+    dstFrontEndReq->preprocessorDefinitions = frontEndReq->preprocessorDefinitions;
+    for (const auto& pair : permutations[permutationIndex].preprocessorDefinitions)
+    {
+        dstFrontEndReq->preprocessorDefinitions[pair.Key] = pair.Value;
+    }
+
+    // The source files are shared, so they are only loaded once
+    for (auto translationUnit : frontEndReq->translationUnits)
+    {
+        const int translationUnitIndex = dstFrontEndReq->addTranslationUnit(translationUnit->sourceLanguage, translationUnit->moduleName);
+        auto dstTranslationUnit = dstFrontEndReq->translationUnits[translationUnitIndex];
+        dstTranslationUnit->preprocessorDefinitions = translationUnit->preprocessorDefinitions;
+        for (auto sourceFile : translationUnit->getSourceFiles())
+        {
+            dstTranslationUnit->addSourceFile(sourceFile);
+        }
+    }
+    for (auto entryPointReq : frontEndReq->getEntryPointReqs())
+    {
+        dstFrontEndReq->addEntryPoint(entryPointReq->getTranslationUnitIndex(), getText(entryPointReq->getName()), entryPointReq->getProfile());
+    }
+
+    return request;
+}
+
+SlangResult EndToEndCompileRequest::_executePermutations()
+{
+    // The permutations share the linkage, so the work up to generating code is done for
+    // each permutation in turn on this thread. That is where the work is shared: the
+    // permutations use the modules imported by the first permutation that imports them,
+    // and the tokens lexed from included files are cached on the linkage.
+    //
+    // Generating code only reads the state of the linkage (once it is prepared), so the
+    // code for the permutations is generated in parallel.
+    const Index permutationCount = permutations.getCount();
+
+    List<std::exception_ptr> exceptions;
+    exceptions.setCount(permutationCount);
+
+    List<Index> codeGenPermutationIndices;
+    for (Index i = 0; i < permutationCount; ++i)
+    {
+        auto request = _createPermutationRequest(i);
+        permutations[i].request = request;
+
+        try
+        {
+            bool isComplete = false;
+            if (SLANG_SUCCEEDED(request->_executeActionsBeforeCodeGen(isComplete)) && !isComplete)
+            {
+                prepareToGenerateOutputConcurrently(request);
+                if (request->getSink()->getErrorCount() == 0)
+                {
+                    codeGenPermutationIndices.add(i);
+                }
+            }
+        }
+        catch (...)
+        {
+            exceptions[i] = std::current_exception();
+        }
+    }
+
+    ParallelUtil::forEach(codeGenPermutationIndices.getCount(), getBackEndReq()->backEndThreadCount, [&](Index index)
+    {
+        const Index permutationIndex = codeGenPermutationIndices[index];
+        try
+        {
+            generateOutputWithoutWriting(permutations[permutationIndex].request);
+        }
+        catch (...)
+        {
+            exceptions[permutationIndex] = std::current_exception();
+        }
+    });
+
+    // Report the diagnostics and write the output in order. If a permutation threw,
+    // the exception is rethrown after its diagnostics, as if compiled serially.
+    SlangResult result = SLANG_OK;
+    for (Index i = 0; i < permutationCount; ++i)
+    {
+        auto request = permutations[i].request;
+        auto requestSink = request->getSink();
+
+        getSink()->appendBufferedDiagnostics(*requestSink);
+        request->mDiagnosticOutput = requestSink->outputBuffer.ProduceString();
+
+        if (exceptions[i])
+        {
+            std::rethrow_exception(exceptions[i]);
+        }
+        if (requestSink->getErrorCount() != 0)
+        {
+            result = SLANG_FAIL;
+        }
+        else if (isCommandLineCompile && codeGenPermutationIndices.contains(i))
+        {
+            writeCommandLineOutput(request);
+        }
+    }
+    return result;
+}
+
 // Act as expected of the API-based compiler
 SlangResult EndToEndCompileRequest::executeActions()
 {
@@ -1606,6 +1858,149 @@ void Linkage::loadParsedModule(
         loadedModule->setIRModule(generateIRForTranslationUnit(getASTBuilder(), translationUnit));
     }
     loadedModulesList.add(loadedModule);
+
+    if (m_reloadChangedModules)
+    {
+        _trackFileDependencies(loadedModule);
+    }
+}
+
+SlangResult Linkage::_calcFileContentHash(String const& path, HashCode64& outHash)
+{
+    ComPtr<ISlangBlob> blob;
+    SLANG_RETURN_ON_FAIL(getFileSystemExt()->loadFile(path.getBuffer(), blob.writeRef()));
+    outHash = getStableHashCode64((const char*)blob->getBufferPointer(), blob->getBufferSize());
+    return SLANG_OK;
+}
+
+void Linkage::_trackFileDependencies(Module* module)
+{
+    // The files were just read to load the module, so with a caching file system
+    // this sees the same contents the module was loaded from.
+    for (auto& path : module->getFilePathDependencyList())
+    {
+        if (m_fileContentHashes.ContainsKey(path))
+        {
+            continue;
+        }
+        HashCode64 hash;
+        if (SLANG_SUCCEEDED(_calcFileContentHash(path, hash)))
+        {
+            m_fileContentHashes.Add(path, hash);
+        }
+    }
+}
+
+void Linkage::removeChangedModules()
+{
+    if (!m_reloadChangedModules)
+    {
+        return;
+    }
+
+    // A module that failed to load is recorded as null, so there isn't another attempt to load it.
+    // The problem may have since been fixed (for example by adding a missing file), so allow another attempt.
+    {
+        List<Name*> failedNames;
+        for (const auto& pair : mapNameToLoadedModules)
+        {
+            if (!pair.Value)
+            {
+                failedNames.add(pair.Key);
+            }
+        }
+        for (auto name : failedNames)
+        {
+            mapNameToLoadedModules.Remove(name);
+        }
+    }
+
+    if (m_fileContentHashes.Count() == 0)
+    {
+        return;
+    }
+
+    // Make sure the current contents are read, not those cached when the modules were loaded
+    getFileSystemExt()->clearCache();
+
+    HashSet<String> changedPaths;
+    for (const auto& pair : m_fileContentHashes)
+    {
+        HashCode64 hash;
+        if (SLANG_FAILED(_calcFileContentHash(pair.Key, hash)) || hash != pair.Value)
+        {
+            changedPaths.Add(pair.Key);
+        }
+    }
+    if (changedPaths.Count() == 0)
+    {
+        return;
+    }
+
+    // The file dependencies of a module include those of all the modules it imports, so this
+    // also removes every module that (transitively) imports a changed module.
+    List<RefPtr<LoadedModule>> keptModules;
+    HashSet<LoadedModule*> removedModules;
+    for (auto& loadedModule : loadedModulesList)
+    {
+        bool hasChanged = false;
+        for (auto& path : loadedModule->getFilePathDependencyList())
+        {
+            if (changedPaths.Contains(path))
+            {
+                hasChanged = true;
+                break;
+            }
+        }
+
+        if (hasChanged)
+        {
+            removedModules.Add(loadedModule);
+        }
+        else
+        {
+            keptModules.add(loadedModule);
+        }
+    }
+
+    {
+        List<String> removedPaths;
+        for (const auto& pair : mapPathToLoadedModule)
+        {
+            if (removedModules.Contains(pair.Value))
+            {
+                removedPaths.add(pair.Key);
+            }
+        }
+        for (auto& path : removedPaths)
+        {
+            mapPathToLoadedModule.Remove(path);
+        }
+
+        List<Name*> removedNames;
+        for (const auto& pair : mapNameToLoadedModules)
+        {
+            if (removedModules.Contains(pair.Value))
+            {
+                removedNames.add(pair.Key);
+            }
+        }
+        for (auto name : removedNames)
+        {
+            mapNameToLoadedModules.Remove(name);
+        }
+    }
+
+    loadedModulesList.swapWith(keptModules);
+
+    // The hashes of the changed files will be recorded again when the modules that use them are reloaded
+    for (auto& path : changedPaths)
+    {
+        m_fileContentHashes.Remove(path);
+    }
+
+    // The type checking cache may refer to declarations in the removed modules
+    destroyTypeCheckingCache();
 }
 
 Module* Linkage::loadModule(String const& name)
@@ -1885,7 +2280,7 @@ RefPtr<EntryPoint> Module::findEntryPointByName(UnownedStringSlice const& name)
 
     for(auto entryPoint : m_entryPoints)
     {
-        if(entryPoint->getName()->text.getUnownedSlice() == name)
+        if(entryPoint->getName()->text == name)
             return entryPoint;
     }
 
@@ -2664,6 +3059,11 @@ void Session::addBuiltinSource(
 
     // Extract the AST for the code we just parsed
     auto module = compileRequest->translationUnits[translationUnitIndex]->getModule();
+    _addBuiltinModule(scope, module);
+}
+
+void Session::_addBuiltinModule(RefPtr<Scope> const& scope, Module* module)
+{
     auto moduleDecl = module->getModuleDecl();
 
     // Add the resulting code to the appropriate scope
@@ -2686,6 +3086,374 @@ void Session::addBuiltinSource(
     stdlibModules.add(module);
 }
 
+static void _buildMemberDictionariesRec(ContainerDecl* containerDecl)
+{
+    buildMemberDictionary(containerDecl);
+    for (auto member : containerDecl->members)
+    {
+        if (auto childContainerDecl = as<ContainerDecl>(member))
+        {
+            _buildMemberDictionariesRec(childContainerDecl);
+        }
+    }
+}
+
+void Session::_freezeStdLib()
+{
+    // Lookup lazily builds the member dictionary of a declaration, so build them all up front
+    // such that lookups into the stdlib don't modify it.
+    _buildMemberDictionariesRec(baseModuleDecl);
+    for (auto module : stdlibModules)
+    {
+        _buildMemberDictionariesRec(module->getModuleDecl());
+
+        // Linking lazily builds the symbol index of an IR module
+        if (auto irModule = module->getIRModule())
+        {
+            irModule->getSymbolIndex();
+        }
+    }
+
+    m_sharedASTBuilder->freeze();
+    m_builtinLinkage->getASTBuilder()->freeze();
+    globalAstBuilder->freeze();
+}
+
+Scope* Session::_findBuiltinModuleScope(Module* module)
+{
+    // The hlsl language scope chain contains any additional stdlib module scopes for hlsl,
+    // followed by the core language scope, followed by any additional core module scopes
+    Scope* languageScope = nullptr;
+    for (Scope* scope = hlslLanguageScope; scope && scope != baseLanguageScope; scope = scope->nextSibling)
+    {
+        if (scope == hlslLanguageScope || scope == coreLanguageScope)
+        {
+            languageScope = scope;
+        }
+        if (scope->containerDecl == module->getModuleDecl())
+        {
+            return languageScope;
+        }
+    }
+    return nullptr;
+}
+
+void Session::initStdLib()
+{
+#if SLANG_EMBED_STDLIB
+    // Loading the serialized stdlib is much faster than compiling it. It can fail if the embedded
+    // stdlib is out of date with the stdlib source, in which case we fall back to compiling.
+    if (SLANG_SUCCEEDED(loadStdLib(g_embeddedStdLib, sizeof(g_embeddedStdLib))))
+    {
+        return;
+    }
+#endif
+    compileStdLib();
+}
+
+SlangResult Session::compileStdLib()
+{
+    if (stdlibModules.getCount())
+    {
+        // Already has a stdlib
+        return SLANG_FAIL;
+    }
+
+    addBuiltinSource(coreLanguageScope, "core", getCoreLibraryCode());
+    addBuiltinSource(hlslLanguageScope, "hlsl", getHLSLLibraryCode());
+
+    _freezeStdLib();
+    return SLANG_OK;
+}
+
+/* The serialized stdlib is a RIFF container holding
+
+* A header, identifying the format version, and the stdlib source it was produced from
+* A table with an entry for each stdlib module, in the order they were added to the session
+* The serialized AST of all of the stdlib modules (modules can reference each other, so they are serialized together)
+* The serialized IR for each module, in the same order as the module table
+*/
+struct StdLibSerialBinary
+{
+    static const FourCC kStdLibFourCc = SLANG_FOUR_CC('S', 'L', 's', 'l');
+    static const FourCC kHeaderFourCc = SLANG_FOUR_CC('S', 'L', 's', 'h');
+    static const FourCC kModuleTableFourCc = SLANG_FOUR_CC('S', 'L', 's', 'm');
+    static const FourCC kASTFourCc = SLANG_FOUR_CC('S', 'L', 'a', 's');
+
+    enum
+    {
+        kVersion = 1,
+    };
+
+    enum class ScopeKind : uint32_t
+    {
+        Core,
+        HLSL,
+    };
+
+    struct Header
+    {
+        uint32_t version;               ///< The format version
+        uint32_t astNodeTypeCount;      ///< ASTNodeType::CountOf, so changes to the AST classes are detected
+        uint32_t irOpCount;             ///< kIROpCount, so changes to the IR opcodes are detected
+        uint32_t pad;
+        uint64_t sourceHash;            ///< Hash of the stdlib source
+    };
+
+    struct ModuleEntry
+    {
+        uint32_t moduleDeclIndex;       ///< The ASTSerialIndex of the modules ModuleDecl
+        uint32_t scopeKind;             ///< The ScopeKind the module is added to
+    };
+};
+
+HashCode64 Session::_calcStdLibSourceHash()
+{
+    const String coreSource = getCoreLibraryCode();
+    const String hlslSource = getHLSLLibraryCode();
+
+    const HashCode64 coreHash = getHashCode64(coreSource.getBuffer(), coreSource.getLength());
+    const HashCode64 hlslHash = getHashCode64(hlslSource.getBuffer(), hlslSource.getLength());
+    return coreHash ^ (hlslHash + 0x9e3779b97f4a7c15ull + (coreHash << 6) + (coreHash >> 2));
+}
+
+SlangResult Session::saveStdLib(ISlangBlob** outBlob)
+{
+    typedef StdLibSerialBinary Bin;
+    typedef RiffContainer::ScopeChunk ScopeChunk;
+    typedef RiffContainer::Chunk Chunk;
+
+    if (stdlibModules.getCount() == 0)
+    {
+        // There is no stdlib to save
+        return SLANG_FAIL;
+    }
+
+    RefPtr<ASTSerialClasses> classes = new ASTSerialClasses;
+    ASTSerialWriter astWriter(classes);
+
+    List<Bin::ModuleEntry> moduleTable;
+    for (auto module : stdlibModules)
+    {
+        Scope* scope = _findBuiltinModuleScope(module);
+        if (!scope)
+        {
+            return SLANG_FAIL;
+        }
+
+        Bin::ModuleEntry entry;
+        entry.moduleDeclIndex = uint32_t(astWriter.addPointer(module->getModuleDecl()));
+        entry.scopeKind = uint32_t((scope == hlslLanguageScope) ? Bin::ScopeKind::HLSL : Bin::ScopeKind::Core);
+        moduleTable.add(entry);
+    }
+
+    List<uint8_t> astData;
+    {
+        OwnedMemoryStream stream(FileAccess::Write);
+        SLANG_RETURN_ON_FAIL(astWriter.write(&stream));
+        stream.swapContents(astData);
+    }
+
+    RiffContainer container;
+    {
+        ScopeChunk scopeStdLib(&container, Chunk::Kind::List, Bin::kStdLibFourCc);
+
+        {
+            Bin::Header header;
+            memset(&header, 0, sizeof(header));
+            header.version = Bin::kVersion;
+            header.astNodeTypeCount = uint32_t(ASTNodeType::CountOf);
+            header.irOpCount = uint32_t(kIROpCount);
+            header.sourceHash = _calcStdLibSourceHash();
+
+            ScopeChunk scopeHeader(&container, Chunk::Kind::Data, Bin::kHeaderFourCc);
+            container.write(&header, sizeof(header));
+        }
+        {
+            ScopeChunk scopeModuleTable(&container, Chunk::Kind::Data, Bin::kModuleTableFourCc);
+            container.write(moduleTable.getBuffer(), moduleTable.getCount() * sizeof(Bin::ModuleEntry));
+        }
+        {
+            ScopeChunk scopeAST(&container, Chunk::Kind::Data, Bin::kASTFourCc);
+            container.write(astData.getBuffer(), astData.getCount());
+        }
+
+        for (auto module : stdlibModules)
+        {
+            IRSerialData serialData;
+            IRSerialWriter writer;
+            SLANG_RETURN_ON_FAIL(writer.write(module->getIRModule(), nullptr, 0, &serialData));
+            SLANG_RETURN_ON_FAIL(IRSerialWriter::writeContainer(serialData, IRSerialCompressionType::VariableByteLite, &container));
+        }
+    }
+
+    OwnedMemoryStream stream(FileAccess::Write);
+    SLANG_RETURN_ON_FAIL(RiffUtil::write(container.getRoot(), true, &stream));
+
+    List<uint8_t> data;
+    stream.swapContents(data);
+
+    *outBlob = ListBlob::moveCreate(data).detach();
+    return SLANG_OK;
+}
+
+SlangResult Session::setDownstreamCompileCache(char const* directory, SlangInt maxSizeInBytes)
+{
+    if (directory == nullptr)
+    {
+        m_downstreamCompileCache.setNull();
+        return SLANG_OK;
+    }
+    if (maxSizeInBytes < 0)
+    {
+        return SLANG_E_INVALID_ARG;
+    }
+
+    RefPtr<DownstreamCompileCache> cache;
+    SLANG_RETURN_ON_FAIL(DownstreamCompileCache::create(directory, uint64_t(maxSizeInBytes), cache));
+    m_downstreamCompileCache = cache;
+    return SLANG_OK;
+}
+
+SlangResult Session::getDownstreamCompileCacheStats(slang::DownstreamCompileCacheStats* outStats)
+{
+    if (!m_downstreamCompileCache)
+    {
+        return SLANG_E_NOT_AVAILABLE;
+    }
+
+    const auto stats = m_downstreamCompileCache->getStats();
+
+    outStats->hitCount = stats.hitCount;
+    outStats->missCount = stats.missCount;
+    outStats->addCount = stats.addCount;
+    outStats->evictionCount = stats.evictionCount;
+    return SLANG_OK;
+}
+
+SlangResult Session::loadStdLib(const void* stdLib, size_t stdLibSizeInBytes)
+{
+    typedef StdLibSerialBinary Bin;
+
+    if (stdlibModules.getCount())
+    {
+        // Already has a stdlib
+        return SLANG_FAIL;
+    }
+
+    RiffContainer container;
+    {
+        MemoryStreamBase stream(FileAccess::Read, stdLib, stdLibSizeInBytes);
+        SLANG_RETURN_ON_FAIL(RiffUtil::read(&stream, container));
+    }
+
+    RiffContainer::ListChunk* stdLibChunk = container.getRoot()->findListRec(Bin::kStdLibFourCc);
+    if (!stdLibChunk)
+    {
+        return SLANG_FAIL;
+    }
+
+    // Check the serialized stdlib is compatible and up to date
+    {
+        RiffContainer::Data* headerData = stdLibChunk->findContainedData(Bin::kHeaderFourCc);
+        if (!headerData || headerData->getSize() < sizeof(Bin::Header))
+        {
+            return SLANG_FAIL;
+        }
+
+        Bin::Header header;
+        memcpy(&header, headerData->getPayload(), sizeof(header));
+
+        if (header.version != Bin::kVersion ||
+            header.astNodeTypeCount != uint32_t(ASTNodeType::CountOf) ||
+            header.irOpCount != uint32_t(kIROpCount) ||
+            header.sourceHash != _calcStdLibSourceHash())
+        {
+            return SLANG_FAIL;
+        }
+    }
+
+    List<Bin::ModuleEntry> moduleTable;
+    {
+        RiffContainer::Data* moduleTableData = stdLibChunk->findContainedData(Bin::kModuleTableFourCc);
+        if (!moduleTableData)
+        {
+            return SLANG_FAIL;
+        }
+        moduleTable.setCount(Index(moduleTableData->getSize() / sizeof(Bin::ModuleEntry)));
+        memcpy(moduleTable.getBuffer(), moduleTableData->getPayload(), moduleTable.getCount() * sizeof(Bin::ModuleEntry));
+    }
+
+    List<RiffContainer::ListChunk*> irModuleChunks;
+    stdLibChunk->findContained(IRSerialBinary::kSlangModuleFourCc, irModuleChunks);
+    if (irModuleChunks.getCount() != moduleTable.getCount())
+    {
+        return SLANG_FAIL;
+    }
+
+    RiffContainer::Data* astData = stdLibChunk->findContainedData(Bin::kASTFourCc);
+    if (!astData)
+    {
+        return SLANG_FAIL;
+    }
+
+    // The AST reader requires the data to be aligned to ASTSerialInfo::MAX_ALIGNMENT
+    List<uint64_t> astBuffer;
+    astBuffer.setCount(Index((astData->getSize() + sizeof(uint64_t) - 1) / sizeof(uint64_t)));
+    memcpy(astBuffer.getBuffer(), astData->getPayload(), astData->getSize());
+
+    // The stdlib AST is held on the builtin linkage, so that it is kept in scope as long as the session
+    RefPtr<ASTSerialClasses> classes = new ASTSerialClasses;
+    ASTSerialReader astReader(classes);
+    SLANG_RETURN_ON_FAIL(astReader.load((const uint8_t*)astBuffer.getBuffer(), astData->getSize(), m_builtinLinkage->getASTBuilder(), getNamePool()));
+
+    List<RefPtr<Module>> modules;
+    for (Index i = 0; i < moduleTable.getCount(); ++i)
+    {
+        ModuleDecl* moduleDecl = astReader.getPointer(ASTSerialIndex(moduleTable[i].moduleDeclIndex)).dynamicCast<ModuleDecl>();
+        if (!moduleDecl)
+        {
+            return SLANG_FAIL;
+        }
+
+        IRSerialData serialData;
+        SLANG_RETURN_ON_FAIL(IRSerialReader::readContainer(irModuleChunks[i], &serialData));
+
+        RefPtr<IRModule> irModule;
+        IRSerialReader irReader;
+        SLANG_RETURN_ON_FAIL(irReader.read(serialData, this, nullptr, irModule));
+
+        RefPtr<Module> module = new Module(m_builtinLinkage);
+        module->setModuleDecl(moduleDecl);
+        module->setIRModule(irModule);
+        moduleDecl->module = module;
+
+        modules.add(module);
+    }
+
+    // Everything is loaded, so we can now make the modules part of the session.
+    for (Index i = 0; i < modules.getCount(); ++i)
+    {
+        Module* module = modules[i];
+        ModuleDecl* moduleDecl = module->getModuleDecl();
+
+        // The parse callbacks are not serialized, but all stdlib syntax is 'simple' syntax
+        for (auto syntaxDecl : moduleDecl->getMembersOfType<SyntaxDecl>())
+        {
+            setSimpleSyntaxParseCallback(syntaxDecl);
+        }
+
+        // Builtin types are registered during checking, which hasn't happened for a loaded module
+        registerBuiltinDecls(this, moduleDecl);
+
+        const auto scopeKind = Bin::ScopeKind(moduleTable[i].scopeKind);
+        _addBuiltinModule((scopeKind == Bin::ScopeKind::HLSL) ? hlslLanguageScope : coreLanguageScope, module);
+    }
+
+    _freezeStdLib();
+    return SLANG_OK;
+}
+
 Session::~Session()
 {
     // destroy modules next
@@ -2700,6 +3468,7 @@ SLANG_API SlangSession* spCreateSession(const char*)
 {
     Slang::RefPtr<Slang::Session> session(new Slang::Session());
     session->init();
+    session->initStdLib();
     // Will be returned with a refcount of 1
     return asExternal(session.detach());
 }
@@ -2711,6 +3480,21 @@ SLANG_API SlangResult slang_createGlobalSession(
     if(apiVersion != 0)
         return SLANG_E_NOT_IMPLEMENTED;
 
+    Slang::RefPtr<Slang::Session> globalSession(new Slang::Session());
+    globalSession->init();
+    globalSession->initStdLib();
+    Slang::ComPtr<slang::IGlobalSession> result(Slang::asExternal(globalSession));
+    *outGlobalSession = result.detach();
+    return SLANG_OK;
+}
+
+SLANG_API SlangResult slang_createGlobalSessionWithoutStdLib(
+    SlangInt                apiVersion,
+    slang::IGlobalSession** outGlobalSession)
+{
+    if(apiVersion != 0)
+        return SLANG_E_NOT_IMPLEMENTED;
+
     Slang::RefPtr<Slang::Session> globalSession(new Slang::Session());
     globalSession->init();
     Slang::ComPtr<slang::IGlobalSession> result(Slang::asExternal(globalSession));
@@ -2841,6 +3625,13 @@ SLANG_API void spSetLineDirectiveMode(
     Slang::asInternal(request)->getBackEndReq()->lineDirectiveMode = Slang::LineDirectiveMode(mode);
 }
 
+SLANG_API void spSetBackEndThreadCount(
+    SlangCompileRequest*    request,
+    int                     threadCount)
+{
+    Slang::asInternal(request)->getBackEndReq()->backEndThreadCount = threadCount < 0 ? 1 : threadCount;
+}
+
 SLANG_API void spSetCommandLineCompilerMode(
     SlangCompileRequest* request)
 {
@@ -3121,6 +3912,42 @@ SLANG_API void spTranslationUnit_addPreprocessorDefine(
     frontEndReq->translationUnits[translationUnitIndex]->preprocessorDefinitions[key] = value;
 }
 
+SLANG_API int spAddPermutation(
+    SlangCompileRequest*    request)
+{
+    auto req = Slang::asInternal(request);
+    return int(req->addPermutation());
+}
+
+SLANG_API void spPermutation_addPreprocessorDefine(
+    SlangCompileRequest*    request,
+    int                     permutationIndex,
+    const char*             key,
+    const char*             value)
+{
+    auto req = Slang::asInternal(request);
+    req->permutations[permutationIndex].preprocessorDefinitions[key] = value;
+}
+
+SLANG_API int spGetPermutationCount(
+    SlangCompileRequest*    request)
+{
+    auto req = Slang::asInternal(request);
+    return int(req->permutations.getCount());
+}
+
+SLANG_API SlangCompileRequest* spGetPermutationRequest(
+    SlangCompileRequest*    request,
+    int                     permutationIndex)
+{
+    auto req = Slang::asInternal(request);
+    if (permutationIndex < 0 || permutationIndex >= req->permutations.getCount())
+    {
+        return nullptr;
+    }
+    return Slang::asExternal(req->permutations[permutationIndex].request.Ptr());
+}
+
 SLANG_API void spAddTranslationUnitSourceFile(
     SlangCompileRequest*    request,
     int                     translationUnitIndex,
@@ -0,0 +1,10 @@
+// include-guard-a.h
+
+// Used by the `include-guard.slang` test
+
+#ifndef INCLUDE_GUARD_A_H
+#define INCLUDE_GUARD_A_H
+
+#define A_VALUE 2.0
+
+#endif // INCLUDE_GUARD_A_H
@@ -0,0 +1,12 @@
+// include-guard-b.h
+
+// Used by the `include-guard.slang` test
+
+#ifndef INCLUDE_GUARD_B_H
+#define INCLUDE_GUARD_B_H
+static const int bCount = 1;
+#endif
+
+// The guard doesn't cover this, so the file is read again each time it is included
+#define B_VALUE 1
+#undef B_VALUE
@@ -0,0 +1,11 @@
+// include-guard-c.h
+
+// Used by the `include-guard.slang` test
+
+#ifndef INCLUDE_GUARD_C_H
+#define INCLUDE_GUARD_C_H
+static const int cCount = 1;
+#else
+// Reading the file again should get here
+#define C_INCLUDED_AGAIN
+#endif
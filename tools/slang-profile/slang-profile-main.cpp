@@ -8,29 +8,310 @@
 #include "../../slang-com-helper.h"
 
 #include "../../source/core/slang-string-util.h"
+#include "../../source/core/slang-flat-dictionary.h"
+#include "../../source/core/slang-parallel-util.h"
+
+#include "../../source/slang/slang-lexer.h"
+#include "../../source/slang/slang-source-loc.h"
+#include "../../source/slang/slang-diagnostics.h"
+#include "../../source/slang/slang-name.h"
 
 using namespace Slang;
 
-SlangResult innerMain(int argc, char** argv)
+static double _getSeconds(uint64_t startTick)
 {
-    auto stdWriters = StdWriters::initDefaultSingleton();
+    return double(ProcessUtil::getClockTick() - startTick) / ProcessUtil::getClockFrequency();
+}
 
+static void _profileSessionCreation()
+{
     // Time the creation of the session
+    const auto startTick = ProcessUtil::getClockTick();
+
+    for (Int i = 0; i < 32; ++i)
     {
-        const auto startTick = ProcessUtil::getClockTick();
+        ComPtr<slang::IGlobalSession> slangSession;
+        slangSession.attach(spCreateSession(nullptr));
+    }
 
-        for (Int i = 0; i < 32; ++i)
+    printf("Ticks %f\n", _getSeconds(startTick));
+}
+
+// Times the operations the IR makes most use of - pointer keys, mostly lookups and adds.
+template <typename DictionaryType>
+static void _profileDictionary(const char* name, const List<int*>& keys, const List<int*>& missingKeys)
+{
+    const Index keyCount = keys.getCount();
+    const Int repeatCount = 20;
+    int total = 0;
+
+    auto startTick = ProcessUtil::getClockTick();
+    for (Int i = 0; i < repeatCount; ++i)
+    {
+        DictionaryType dict;
+        for (Index j = 0; j < keyCount; ++j)
         {
-            ComPtr<slang::IGlobalSession> slangSession;
-            slangSession.attach(spCreateSession(nullptr));
+            dict.Add(keys[j], int(j));
         }
+        total += dict.Count();
+    }
+    const double addTime = _getSeconds(startTick);
 
-        const auto endTick = ProcessUtil::getClockTick();
+    DictionaryType dict;
+    for (Index j = 0; j < keyCount; ++j)
+    {
+        dict.Add(keys[j], int(j));
+    }
 
-        printf("Ticks %f\n", double(endTick - startTick) / ProcessUtil::getClockFrequency());
-        return SLANG_OK;
+    startTick = ProcessUtil::getClockTick();
+    for (Int i = 0; i < repeatCount; ++i)
+    {
+        for (Index j = 0; j < keyCount; ++j)
+        {
+            total += *dict.TryGetValue(keys[j]);
+        }
     }
+    const double findTime = _getSeconds(startTick);
+
+    startTick = ProcessUtil::getClockTick();
+    for (Int i = 0; i < repeatCount; ++i)
+    {
+        for (Index j = 0; j < keyCount; ++j)
+        {
+            total += int(dict.ContainsKey(missingKeys[j]));
+        }
+    }
+    const double missTime = _getSeconds(startTick);
+
+    startTick = ProcessUtil::getClockTick();
+    for (Int i = 0; i < repeatCount; ++i)
+    {
+        for (Index j = 0; j < keyCount; j += 2)
+        {
+            dict.Remove(keys[j]);
+        }
+        for (Index j = 0; j < keyCount; j += 2)
+        {
+            dict.Add(keys[j], int(j));
+        }
+    }
+    const double churnTime = _getSeconds(startTick);
+
+    printf("%s: add %f find %f miss %f remove/add %f (%d)\n", name, addTime, findTime, missTime, churnTime, total);
+}
+
+static void _profileDictionaries()
+{
+    const Index keyCount = 100000;
+
+    // Keys are the addresses of heap allocations, like the IR instructions used as keys in the IR
+    List<int*> keys;
+    List<int*> missingKeys;
+    for (Index i = 0; i < keyCount; ++i)
+    {
+        keys.add(new int(int(i)));
+        missingKeys.add(new int(int(i)));
+    }
+
+    _profileDictionary<Dictionary<int*, int>>("Dictionary", keys, missingKeys);
+    _profileDictionary<FlatDictionary<int*, int>>("FlatDictionary", keys, missingKeys);
+
+    for (Index i = 0; i < keyCount; ++i)
+    {
+        delete keys[i];
+        delete missingKeys[i];
+    }
+}
+
+// Makes source that looks like a large generated shader header
+static String _makeLexerSource(Index materialCount)
+{
+    StringBuilder buf;
+    for (Index i = 0; i < materialCount; ++i)
+    {
+        buf << "/* Generated declarations for material " << i << ".\n";
+        buf << " * Contains the parameters used by the lighting and shading functions. */\n";
+        buf << "struct MaterialParameters_" << i << "\n{\n";
+        buf << "    float4      baseColorFactor;            // linear RGBA\n";
+        buf << "    float3      emissiveFactor;             // linear RGB\n";
+        buf << "    float       metallicRoughnessScale_" << i << " = " << i << ".25f;\n";
+        buf << "    uint        textureFlags = 0x" << (i * 7919) << "u;\n";
+        buf << "};\n\n";
+        buf << "#define MATERIAL_" << i << "_SCALE(x) \\\n    ((x) * " << i << ".0)\n\n";
+        buf << "float3 evaluateMaterial_" << i << "(MaterialParameters_" << i << " params, float3 normalWorldSpace)\n{\n";
+        buf << "\t\treturn params.baseColorFactor.xyz * saturate(dot(normalWorldSpace, float3(0.5, 0.25, 1.0e-3)));\n";
+        buf << "}\n\n";
+    }
+    return buf.ProduceString();
+}
+
+// Times lexing all of the tokens of a file (or of generated source if there isn't one), reporting the throughput
+static void _profileLexer(const char* path)
+{
+    const String source = path ? File::readAllText(path) : _makeLexerSource(4000);
+
+    SourceManager sourceManager;
+    sourceManager.initialize(nullptr, nullptr);
+
+    DiagnosticSink sink(&sourceManager);
+
+    RootNamePool rootNamePool;
+    NamePool namePool;
+    namePool.setRootNamePool(&rootNamePool);
+
+    SourceFile* sourceFile = sourceManager.createSourceFileWithString(PathInfo::makePath(path ? path : "generated.slang"), source);
+    SourceView* sourceView = sourceManager.createSourceView(sourceFile, nullptr);
 
+    const Int repeatCount = 20;
+    Index tokenCount = 0;
+
+    const auto startTick = ProcessUtil::getClockTick();
+    for (Int i = 0; i < repeatCount; ++i)
+    {
+        Lexer lexer;
+        lexer.initialize(sourceView, &sink, &namePool, sourceManager.getMemoryArena());
+        TokenList tokens = lexer.lexAllTokens();
+        tokenCount = tokens.m_tokens.getCount();
+    }
+    const double seconds = _getSeconds(startTick);
+
+    const double megaBytes = double(source.getLength()) * repeatCount / (1024.0 * 1024.0);
+    printf("Lexer: %d tokens in %f MB, %f s, %f MB/s\n", int(tokenCount), megaBytes / repeatCount, seconds, megaBytes / seconds);
+}
+
+// Makes a module, a header and a shader that imports and includes them, which has a permutation for each value of PERMUTATION
+static void _writePermutationSources(const String& dir)
+{
+    StringBuilder buf;
+    for (Index i = 0; i < 200; ++i)
+    {
+        buf << "public struct Light_" << i << " { public float3 direction; public float3 color; public float range; };\n";
+        buf << "public float3 evaluateLight_" << i << "(Light_" << i << " light, float3 normal)\n{\n";
+        buf << "    return light.color * saturate(dot(normal, normalize(light.direction))) / max(light.range, " << i << ".5);\n";
+        buf << "}\n";
+    }
+    File::writeAllText(Path::combine(dir, "profile-permutations-lighting.slang"), buf);
+
+    buf.Clear();
+    buf << "#ifndef PROFILE_PERMUTATIONS_H\n#define PROFILE_PERMUTATIONS_H\n";
+    buf << _makeLexerSource(200);
+    buf << "#endif\n";
+    File::writeAllText(Path::combine(dir, "profile-permutations.h"), buf);
+
+    buf.Clear();
+    buf << "import profile_permutations_lighting;\n";
+    buf << "#include \"profile-permutations.h\"\n";
+    buf << "RWStructuredBuffer<float4> outputBuffer;\n";
+    buf << "[numthreads(8, 8, 1)]\n";
+    buf << "void computeMain(uint3 tid : SV_DispatchThreadID)\n{\n";
+    buf << "    float3 normal = normalize(float3(tid));\n";
+    buf << "    float3 color = float3(0);\n";
+    buf << "    Light_7 light = { float3(1, 2, 3), float3(1), 10 };\n";
+    buf << "#if PERMUTATION & 1\n    color += evaluateLight_7(light, normal);\n#endif\n";
+    buf << "    MaterialParameters_3 material = { float4(1), float3(0), 0.5, 0 };\n";
+    buf << "#if PERMUTATION & 2\n    color += evaluateMaterial_3(material, normal);\n#endif\n";
+    buf << "#if PERMUTATION & 4\n    color = MATERIAL_9_SCALE(color);\n#endif\n";
+    buf << "    outputBuffer[tid.x] = float4(color, PERMUTATION);\n";
+    buf << "}\n";
+    File::writeAllText(Path::combine(dir, "profile-permutations.slang"), buf);
+}
+
+static SlangCompileRequest* _createPermutationsRequest(SlangSession* session, const String& dir)
+{
+    SlangCompileRequest* request = spCreateCompileRequest(session);
+    spAddCodeGenTarget(request, SLANG_HLSL);
+    spAddSearchPath(request, dir.getBuffer());
+    int tuIndex = spAddTranslationUnit(request, SLANG_SOURCE_LANGUAGE_SLANG, nullptr);
+    spAddTranslationUnitSourceFile(request, tuIndex, Path::combine(dir, "profile-permutations.slang").getBuffer());
+    spAddEntryPoint(request, tuIndex, "computeMain", SLANG_STAGE_COMPUTE);
+    return request;
+}
+
+// Times compiling permutations of a shader with a request for each, against compiling them with one request
+static void _profilePermutations(Index permutationCount)
+{
+    String tempPath;
+    if (SLANG_FAILED(File::generateTemporary(UnownedStringSlice::fromLiteral("slang-profile"), tempPath)))
+    {
+        printf("Unable to create temporary file\n");
+        return;
+    }
+    const String dir = Path::getParentDirectory(tempPath);
+    File::remove(tempPath);
+    _writePermutationSources(dir);
+
+    ComPtr<slang::IGlobalSession> session;
+    session.attach(spCreateSession(nullptr));
+
+    // Compile the stdlib, so it isn't part of the first time
+    {
+        SlangCompileRequest* request = _createPermutationsRequest(session, dir);
+        spAddPreprocessorDefine(request, "PERMUTATION", "0");
+        spCompile(request);
+        spDestroyCompileRequest(request);
+    }
+
+    auto startTick = ProcessUtil::getClockTick();
+    for (Index i = 0; i < permutationCount; ++i)
+    {
+        SlangCompileRequest* request = _createPermutationsRequest(session, dir);
+        spAddPreprocessorDefine(request, "PERMUTATION", String(i).getBuffer());
+        if (SLANG_FAILED(spCompile(request)))
+        {
+            printf("%s", spGetDiagnosticOutput(request));
+        }
+        spDestroyCompileRequest(request);
+    }
+    const double separateTime = _getSeconds(startTick);
+    printf("Separate requests: %d permutations, %f s\n", int(permutationCount), separateTime);
+
+    for (int threadCount : { 1, 0 })
+    {
+        startTick = ProcessUtil::getClockTick();
+
+        SlangCompileRequest* request = _createPermutationsRequest(session, dir);
+        spSetBackEndThreadCount(request, threadCount);
+        for (Index i = 0; i < permutationCount; ++i)
+        {
+            const int permutationIndex = spAddPermutation(request);
+            spPermutation_addPreprocessorDefine(request, permutationIndex, "PERMUTATION", String(i).getBuffer());
+        }
+        if (SLANG_FAILED(spCompile(request)))
+        {
+            printf("%s", spGetDiagnosticOutput(request));
+        }
+        spDestroyCompileRequest(request);
+
+        const double batchTime = _getSeconds(startTick);
+        printf("Batched request (%d threads): %d permutations, %f s, speedup %.2fx\n",
+            int(threadCount ? threadCount : ParallelUtil::getHardwareThreadCount()), int(permutationCount), batchTime, separateTime / batchTime);
+    }
+
+    File::remove(Path::combine(dir, "profile-permutations-lighting.slang"));
+    File::remove(Path::combine(dir, "profile-permutations.h"));
+    File::remove(Path::combine(dir, "profile-permutations.slang"));
+}
+
+SlangResult innerMain(int argc, char** argv)
+{
+    auto stdWriters = StdWriters::initDefaultSingleton();
+
+    if (argc > 1 && UnownedStringSlice(argv[1]) == "dictionary")
+    {
+        _profileDictionaries();
+    }
+    else if (argc > 1 && UnownedStringSlice(argv[1]) == "lexer")
+    {
+        _profileLexer(argc > 2 ? argv[2] : nullptr);
+    }
+    else if (argc > 1 && UnownedStringSlice(argv[1]) == "permutations")
+    {
+        _profilePermutations(argc > 2 ? StringToInt(argv[2]) : 64);
+    }
+    else
+    {
+        _profileSessionCreation();
+    }
     return SLANG_OK;
 }
 
@@ -0,0 +1,95 @@
+// unit-test-concurrent-compile.cpp
+
+#include "../../slang.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <thread>
+
+#include "../../source/core/slang-list.h"
+#include "../../source/core/slang-string.h"
+
+#include "test-context.h"
+
+using namespace Slang;
+
+static const char kConcurrentCompileSource[] =
+    "struct Thing { float3 a; int b; };\n"
+    "RWStructuredBuffer<float> outputBuffer;\n"
+    "StructuredBuffer<Thing> things;\n"
+    "[numthreads(4, 1, 1)]\n"
+    "void computeMain(uint3 tid : SV_DispatchThreadID)\n"
+    "{\n"
+    "    Thing thing = things[tid.x];\n"
+    "    float3x3 m = float3x3(thing.a, thing.a.yzx, thing.a.zxy);\n"
+    "    float3 v = mul(m, normalize(thing.a));\n"
+    "    outputBuffer[tid.x] = length(v) + float(half(thing.b)) * 2.0f + dot(m[1], float3(1, 2, 3));\n"
+    "}\n";
+
+static String _compile(SlangSession* session, SlangCompileTarget target)
+{
+    SlangCompileRequest* request = spCreateCompileRequest(session);
+    spAddCodeGenTarget(request, target);
+    int tuIndex = spAddTranslationUnit(request, SLANG_SOURCE_LANGUAGE_SLANG, "tu");
+    spAddTranslationUnitSourceString(request, tuIndex, "concurrent.slang", kConcurrentCompileSource);
+    spAddEntryPoint(request, tuIndex, "computeMain", SLANG_STAGE_COMPUTE);
+
+    String code;
+    if (SLANG_SUCCEEDED(spCompile(request)))
+    {
+        code = spGetEntryPointSource(request, 0);
+    }
+    spDestroyCompileRequest(request);
+    return code;
+}
+
+static void concurrentCompileTest()
+{
+    const SlangCompileTarget targets[] = { SLANG_HLSL, SLANG_GLSL };
+    const Index targetCount = SLANG_COUNT_OF(targets);
+
+    // All of the threads share the session, and so its stdlib
+    SlangSession* session = spCreateSession();
+
+    enum { kThreadCount = 4, kCompilesPerThread = 4 };
+
+    // Each thread records the code produced for each target on each of its compiles
+    List<String> results;
+    results.setCount(kThreadCount * kCompilesPerThread * targetCount);
+
+    List<std::thread> threads;
+    for (Index i = 0; i < kThreadCount; ++i)
+    {
+        threads.add(std::thread([&, i]()
+        {
+            for (Index j = 0; j < kCompilesPerThread; ++j)
+            {
+                for (Index k = 0; k < targetCount; ++k)
+                {
+                    results[(i * kCompilesPerThread + j) * targetCount + k] = _compile(session, targets[k]);
+                }
+            }
+        }));
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // The output should be the same as when compiled on a single thread
+    for (Index k = 0; k < targetCount; ++k)
+    {
+        const String expected = _compile(session, targets[k]);
+        SLANG_CHECK(expected.getLength() > 0);
+
+        for (Index i = 0; i < kThreadCount * kCompilesPerThread; ++i)
+        {
+            SLANG_CHECK(results[i * targetCount + k] == expected);
+        }
+    }
+
+    spDestroySession(session);
+}
+
+SLANG_UNIT_TEST("concurrentCompile", concurrentCompileTest);
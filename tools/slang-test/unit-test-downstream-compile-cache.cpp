@@ -0,0 +1,146 @@
+// unit-test-downstream-compile-cache.cpp
+
+#include "../../source/core/slang-downstream-compile-cache.h"
+
+#include "../../source/core/slang-blob.h"
+#include "../../source/core/slang-io.h"
+
+#include "test-context.h"
+
+using namespace Slang;
+
+static bool _isBlobEqual(ISlangBlob* blob, const List<uint8_t>& data)
+{
+    return blob && blob->getBufferSize() == size_t(data.getCount()) &&
+        ::memcmp(blob->getBufferPointer(), data.getBuffer(), size_t(data.getCount())) == 0;
+}
+
+static String _makeKey(Index index)
+{
+    DownstreamCompiler::Desc desc(SLANG_PASS_THROUGH_GCC, 9, 3);
+    DownstreamCompiler::CompileOptions options;
+    options.sourceContents = "int f() { return 1; }\n";
+    options.sourceContentsPath = "f.cpp";
+
+    DownstreamCompiler::Define define;
+    define.nameWithSig = "INDEX";
+    define.value = String(index);
+    options.defines.add(define);
+
+    StringBuilder builder;
+    DownstreamCompileCache::appendKey(desc, options, builder);
+    return builder.ProduceString();
+}
+
+static void downstreamCompileCacheUnitTest()
+{
+    // Use a uniquely named directory in the temporary directory
+    String directory;
+    SLANG_CHECK_ABORT(SLANG_SUCCEEDED(File::generateTemporary(UnownedStringSlice::fromLiteral("slang-test-cache"), directory)));
+    File::remove(directory);
+
+    {
+        RefPtr<DownstreamCompileCache> cache;
+        SLANG_CHECK_ABORT(SLANG_SUCCEEDED(DownstreamCompileCache::create(directory, 0, cache)));
+        SLANG_CHECK(cache->getMaxSizeInBytes() == DownstreamCompileCache::kDefaultMaxSizeInBytes);
+
+        List<uint8_t> binary;
+        for (Index i = 0; i < 100; ++i)
+        {
+            binary.add(uint8_t(i * 7));
+        }
+        ComPtr<ISlangBlob> binaryBlob = createRawBlob(binary.getBuffer(), size_t(binary.getCount()));
+
+        DownstreamDiagnostics diagnostics;
+        {
+            DownstreamDiagnostic diagnostic;
+            diagnostic.reset();
+            diagnostic.type = DownstreamDiagnostic::Type::Warning;
+            diagnostic.text = "unused variable 'x'";
+            diagnostic.code = "W123";
+            diagnostic.filePath = "f.cpp";
+            diagnostic.fileLine = 10;
+            diagnostics.diagnostics.add(diagnostic);
+        }
+        diagnostics.rawDiagnostics = "f.cpp(10): warning W123: unused variable 'x'";
+
+        const String key = _makeKey(0);
+
+        // Nothing is in the cache
+        DownstreamDiagnostics foundDiagnostics;
+        ComPtr<ISlangBlob> foundBlob;
+        SLANG_CHECK(cache->find(key, foundDiagnostics, foundBlob) == SLANG_E_NOT_FOUND);
+
+        SLANG_CHECK(SLANG_SUCCEEDED(cache->add(key, diagnostics, binaryBlob)));
+
+        // It's found, with the same diagnostics and binary
+        SLANG_CHECK(SLANG_SUCCEEDED(cache->find(key, foundDiagnostics, foundBlob)));
+        SLANG_CHECK(_isBlobEqual(foundBlob, binary));
+        SLANG_CHECK(foundDiagnostics.rawDiagnostics == diagnostics.rawDiagnostics);
+        SLANG_CHECK(foundDiagnostics.diagnostics.getCount() == 1);
+        if (foundDiagnostics.diagnostics.getCount() == 1)
+        {
+            const auto& found = foundDiagnostics.diagnostics[0];
+            SLANG_CHECK(found.type == DownstreamDiagnostic::Type::Warning);
+            SLANG_CHECK(found.text == "unused variable 'x'" && found.code == "W123" && found.filePath == "f.cpp" && found.fileLine == 10);
+        }
+
+        // A key that differs only in the options is a miss
+        SLANG_CHECK(cache->find(_makeKey(1), foundDiagnostics, foundBlob) == SLANG_E_NOT_FOUND);
+
+        {
+            const auto stats = cache->getStats();
+            SLANG_CHECK(stats.hitCount == 1 && stats.missCount == 2 && stats.addCount == 1 && stats.evictionCount == 0);
+        }
+
+        // A new cache on the same directory sees the entry
+        {
+            RefPtr<DownstreamCompileCache> otherCache;
+            SLANG_CHECK(SLANG_SUCCEEDED(DownstreamCompileCache::create(directory, 0, otherCache)));
+            SLANG_CHECK(SLANG_SUCCEEDED(otherCache->find(key, foundDiagnostics, foundBlob)));
+            SLANG_CHECK(_isBlobEqual(foundBlob, binary));
+        }
+
+        SLANG_CHECK(SLANG_SUCCEEDED(cache->clear()));
+        SLANG_CHECK(cache->calcSizeInBytes() == 0);
+        SLANG_CHECK(cache->find(key, foundDiagnostics, foundBlob) == SLANG_E_NOT_FOUND);
+    }
+
+    // Check the size is capped
+    {
+        const uint64_t maxSizeInBytes = 16 * 1024;
+
+        RefPtr<DownstreamCompileCache> cache;
+        SLANG_CHECK_ABORT(SLANG_SUCCEEDED(DownstreamCompileCache::create(directory, maxSizeInBytes, cache)));
+
+        List<uint8_t> binary;
+        binary.setCount(4000);
+        ::memset(binary.getBuffer(), 0x5a, size_t(binary.getCount()));
+        ComPtr<ISlangBlob> binaryBlob = createRawBlob(binary.getBuffer(), size_t(binary.getCount()));
+
+        DownstreamDiagnostics diagnostics;
+
+        const Index entryCount = 20;
+        for (Index i = 0; i < entryCount; ++i)
+        {
+            SLANG_CHECK(SLANG_SUCCEEDED(cache->add(_makeKey(i), diagnostics, binaryBlob)));
+            SLANG_CHECK(cache->calcSizeInBytes() <= maxSizeInBytes);
+        }
+
+        const auto stats = cache->getStats();
+        SLANG_CHECK(stats.addCount == entryCount);
+        SLANG_CHECK(stats.evictionCount > 0);
+
+        // The most recently added is always kept
+        DownstreamDiagnostics foundDiagnostics;
+        ComPtr<ISlangBlob> foundBlob;
+        SLANG_CHECK(SLANG_SUCCEEDED(cache->find(_makeKey(entryCount - 1), foundDiagnostics, foundBlob)));
+        SLANG_CHECK(_isBlobEqual(foundBlob, binary));
+
+        cache->clear();
+    }
+
+    File::remove(directory);
+}
+
+SLANG_UNIT_TEST("DownstreamCompileCache", downstreamCompileCacheUnitTest);
@@ -0,0 +1,139 @@
+// unit-test-flat-dictionary.cpp
+
+#include "../../source/core/slang-flat-dictionary.h"
+
+#include "test-context.h"
+
+#include "../../source/core/slang-random-generator.h"
+#include "../../source/core/slang-string.h"
+
+using namespace Slang;
+
+template <typename TKey, typename TValue>
+static bool _isEqual(const FlatDictionary<TKey, TValue>& flat, const Dictionary<TKey, TValue>& dict)
+{
+    if (flat.Count() != dict.Count())
+    {
+        return false;
+    }
+    int count = 0;
+    for (auto& pair : flat)
+    {
+        const TValue* value = dict.TryGetValue(pair.Key);
+        if (!value || !(*value == pair.Value))
+        {
+            return false;
+        }
+        count++;
+    }
+    return count == dict.Count();
+}
+
+static void flatDictionaryUnitTest()
+{
+    DefaultRandomGenerator randGen(0x5a17);
+
+    // Compare against Dictionary with a random mix of operations. The key range is small, so there are
+    // plenty of hits, and lots of removes so deleted slots are reused and rehashed away.
+    {
+        FlatDictionary<int, int> flat;
+        Dictionary<int, int> dict;
+
+        for (int i = 0; i < 20000; ++i)
+        {
+            const int key = randGen.nextInt32UpTo(1000);
+            const int value = randGen.nextInt32();
+
+            switch (randGen.nextInt32UpTo(5))
+            {
+                case 0:
+                {
+                    SLANG_CHECK(flat.AddIfNotExists(key, value) == dict.AddIfNotExists(key, value));
+                    break;
+                }
+                case 1:
+                {
+                    flat[key] = value;
+                    dict[key] = value;
+                    break;
+                }
+                case 2:
+                {
+                    int* flatValue = flat.TryGetValueOrAdd(key, value);
+                    int* dictValue = dict.TryGetValueOrAdd(key, value);
+                    SLANG_CHECK((flatValue == nullptr) == (dictValue == nullptr));
+                    SLANG_CHECK(flatValue == nullptr || *flatValue == *dictValue);
+                    break;
+                }
+                default:
+                {
+                    flat.Remove(key);
+                    dict.Remove(key);
+                    break;
+                }
+            }
+
+            SLANG_CHECK(flat.ContainsKey(key) == dict.ContainsKey(key));
+        }
+        SLANG_CHECK(_isEqual(flat, dict));
+
+        // Copy and move
+        {
+            FlatDictionary<int, int> copy(flat);
+            SLANG_CHECK(_isEqual(copy, dict));
+
+            FlatDictionary<int, int> moved(_Move(copy));
+            SLANG_CHECK(_isEqual(moved, dict));
+            SLANG_CHECK(copy.Count() == 0 && copy.begin() == copy.end() && !copy.ContainsKey(0));
+        }
+
+        flat.Clear();
+        SLANG_CHECK(flat.Count() == 0 && flat.begin() == flat.end());
+        flat.Add(1, 2);
+        SLANG_CHECK(flat.Count() == 1 && int(flat[1]) == 2);
+    }
+
+    // Grow from empty, with keys that differ only in high bits
+    {
+        FlatDictionary<int64_t, int64_t> flat;
+        for (int64_t i = 0; i < 5000; ++i)
+        {
+            flat.Add(i << 32, i);
+        }
+        SLANG_CHECK(flat.Count() == 5000);
+
+        bool isOk = true;
+        for (int64_t i = 0; i < 5000; ++i)
+        {
+            const int64_t* value = flat.TryGetValue(i << 32);
+            isOk = isOk && value && *value == i;
+        }
+        SLANG_CHECK(isOk);
+        SLANG_CHECK(!flat.ContainsKey(int64_t(5000) << 32));
+    }
+
+    // Values that own memory are released on remove, and a set works
+    {
+        FlatDictionary<String, String> flat;
+        flat.Add("hello", "world");
+        flat.Add("a", "b");
+        SLANG_CHECK(flat["hello"].GetValue() == "world");
+        flat.Remove("hello");
+        SLANG_CHECK(!flat.ContainsKey("hello") && flat.Count() == 1);
+
+        FlatHashSet<String> set;
+        SLANG_CHECK(set.Add("x"));
+        SLANG_CHECK(!set.Add("x"));
+        SLANG_CHECK(set.Add("y"));
+        SLANG_CHECK(set.Contains("x") && set.Contains("y") && !set.Contains("z"));
+        int count = 0;
+        for (auto& value : set)
+        {
+            SLANG_CHECK(value == "x" || value == "y");
+            count++;
+        }
+        SLANG_CHECK(count == 2);
+    }
+}
+
+SLANG_UNIT_TEST("FlatDictionary", flatDictionaryUnitTest);
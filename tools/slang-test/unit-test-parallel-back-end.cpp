@@ -0,0 +1,112 @@
+// unit-test-parallel-back-end.cpp
+
+#include "../../slang.h"
+#include "../../slang-com-ptr.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../source/core/slang-list.h"
+#include "../../source/core/slang-string.h"
+
+#include "test-context.h"
+
+using namespace Slang;
+
+static const char kParallelBackEndSource[] =
+    "RWStructuredBuffer<float> outputBuffer;\n"
+    "float3 shade(float3 n, float3 l) { return saturate(dot(normalize(n), l)) * n; }\n"
+    "[numthreads(4, 1, 1)]\n"
+    "void computeA(uint3 tid : SV_DispatchThreadID)\n"
+    "{\n"
+    "    outputBuffer[tid.x] = shade(float3(tid), float3(1, 0, 0)).x;\n"
+    "}\n"
+    "[numthreads(8, 1, 1)]\n"
+    "void computeB(uint3 tid : SV_DispatchThreadID)\n"
+    "{\n"
+    "    float2x2 m = float2x2(1, 2, 3, float(tid.y));\n"
+    "    outputBuffer[tid.x] = mul(m, float2(tid.xy)).y / 3.0f;\n"
+    "}\n"
+    "[numthreads(2, 2, 1)]\n"
+    "void computeC(uint3 tid : SV_DispatchThreadID)\n"
+    "{\n"
+    "    outputBuffer[tid.x] = length(shade(float3(tid.yxz), float3(0, 1, 0))) + computeNothing();\n"
+    "}\n"
+    "float computeNothing() { return 0.0f; }\n";
+
+static const char* const kEntryPointNames[] = { "computeA", "computeB", "computeC" };
+
+static const SlangCompileTarget kTargets[] = { SLANG_HLSL, SLANG_GLSL, SLANG_CPP_SOURCE };
+
+    /// Compile all the entry points for all targets, returning the code for each
+    /// (target, entry point) pair followed by the diagnostics.
+static List<String> _compile(SlangSession* session, int threadCount)
+{
+    SlangCompileRequest* request = spCreateCompileRequest(session);
+    spSetBackEndThreadCount(request, threadCount);
+
+    for (auto target : kTargets)
+    {
+        spAddCodeGenTarget(request, target);
+    }
+
+    int tuIndex = spAddTranslationUnit(request, SLANG_SOURCE_LANGUAGE_SLANG, "tu");
+    spAddTranslationUnitSourceString(request, tuIndex, "parallel.slang", kParallelBackEndSource);
+    for (auto name : kEntryPointNames)
+    {
+        spAddEntryPoint(request, tuIndex, name, SLANG_STAGE_COMPUTE);
+    }
+
+    List<String> results;
+    if (SLANG_SUCCEEDED(spCompile(request)))
+    {
+        for (int targetIndex = 0; targetIndex < int(SLANG_COUNT_OF(kTargets)); ++targetIndex)
+        {
+            for (int entryPointIndex = 0; entryPointIndex < int(SLANG_COUNT_OF(kEntryPointNames)); ++entryPointIndex)
+            {
+                ComPtr<ISlangBlob> blob;
+                String code;
+                if (SLANG_SUCCEEDED(spGetEntryPointCodeBlob(request, entryPointIndex, targetIndex, blob.writeRef())))
+                {
+                    code = UnownedStringSlice((const char*)blob->getBufferPointer(), blob->getBufferSize());
+                }
+                results.add(code);
+            }
+        }
+    }
+    results.add(spGetDiagnosticOutput(request));
+
+    spDestroyCompileRequest(request);
+    return results;
+}
+
+static void parallelBackEndTest()
+{
+    SlangSession* session = spCreateSession();
+
+    const List<String> expected = _compile(session, 1);
+    SLANG_CHECK(expected.getCount() == SLANG_COUNT_OF(kTargets) * SLANG_COUNT_OF(kEntryPointNames) + 1);
+
+    for (Index i = 0; i < expected.getCount() - 1; ++i)
+    {
+        SLANG_CHECK(expected[i].getLength() > 0);
+    }
+
+    // Generating the code on multiple threads should produce exactly the same output
+    for (int threadCount : { 0, 2, 4 })
+    {
+        const List<String> results = _compile(session, threadCount);
+        SLANG_CHECK(results.getCount() == expected.getCount());
+        if (results.getCount() == expected.getCount())
+        {
+            for (Index i = 0; i < expected.getCount(); ++i)
+            {
+                SLANG_CHECK(results[i] == expected[i]);
+            }
+        }
+    }
+
+    spDestroySession(session);
+}
+
+SLANG_UNIT_TEST("parallelBackEnd", parallelBackEndTest);
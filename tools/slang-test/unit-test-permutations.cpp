@@ -0,0 +1,193 @@
+// unit-test-permutations.cpp
+
+#include "../../slang.h"
+#include "../../slang-com-ptr.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../source/core/slang-list.h"
+#include "../../source/core/slang-string.h"
+
+#include "test-context.h"
+
+using namespace Slang;
+
+static const char kPermutationsSource[] =
+    "RWStructuredBuffer<float> outputBuffer;\n"
+    "float shade(float3 n)\n"
+    "{\n"
+    "#if USE_LIGHTING\n"
+    "    return saturate(dot(normalize(n), float3(0, 1, 0))) * LIGHT_SCALE;\n"
+    "#else\n"
+    "    return n.x;\n"
+    "#endif\n"
+    "}\n"
+    "[numthreads(4, 1, 1)]\n"
+    "void computeA(uint3 tid : SV_DispatchThreadID)\n"
+    "{\n"
+    "    outputBuffer[tid.x] = shade(float3(tid));\n"
+    "}\n"
+    "[numthreads(8, 1, 1)]\n"
+    "void computeB(uint3 tid : SV_DispatchThreadID)\n"
+    "{\n"
+    "    outputBuffer[tid.x] = shade(float3(tid.yxz)) + QUALITY;\n"
+    "}\n";
+
+static const char* const kEntryPointNames[] = { "computeA", "computeB" };
+
+static const SlangCompileTarget kTargets[] = { SLANG_HLSL, SLANG_GLSL };
+
+    /// The definitions for each permutation. The last one is missing LIGHT_SCALE, so fails to compile.
+static const char* const kPermutationDefines[][3][2] =
+{
+    { { "USE_LIGHTING", "1" }, { "LIGHT_SCALE", "2.0" }, { "QUALITY", "1" } },
+    { { "USE_LIGHTING", "0" }, { "QUALITY", "3" } },
+    { { "USE_LIGHTING", "1" }, { "LIGHT_SCALE", "0.5" } },
+    { { "USE_LIGHTING", "1" } },
+};
+
+static SlangCompileRequest* _createRequest(SlangSession* session)
+{
+    SlangCompileRequest* request = spCreateCompileRequest(session);
+    for (auto target : kTargets)
+    {
+        spAddCodeGenTarget(request, target);
+    }
+
+    // Defined for all of the permutations, but can be redefined by them
+    spAddPreprocessorDefine(request, "QUALITY", "2");
+
+    int tuIndex = spAddTranslationUnit(request, SLANG_SOURCE_LANGUAGE_SLANG, "tu");
+    spAddTranslationUnitSourceString(request, tuIndex, "permutations.slang", kPermutationsSource);
+    for (auto name : kEntryPointNames)
+    {
+        spAddEntryPoint(request, tuIndex, name, SLANG_STAGE_COMPUTE);
+    }
+    return request;
+}
+
+    /// Get the code for each (target, entry point) pair of a compiled request, followed by the diagnostics
+static List<String> _getResults(SlangCompileRequest* request, SlangResult compileResult)
+{
+    List<String> results;
+    if (SLANG_SUCCEEDED(compileResult))
+    {
+        for (int targetIndex = 0; targetIndex < int(SLANG_COUNT_OF(kTargets)); ++targetIndex)
+        {
+            for (int entryPointIndex = 0; entryPointIndex < int(SLANG_COUNT_OF(kEntryPointNames)); ++entryPointIndex)
+            {
+                ComPtr<ISlangBlob> blob;
+                String code;
+                if (SLANG_SUCCEEDED(spGetEntryPointCodeBlob(request, entryPointIndex, targetIndex, blob.writeRef())))
+                {
+                    code = UnownedStringSlice((const char*)blob->getBufferPointer(), blob->getBufferSize());
+                }
+                results.add(code);
+            }
+        }
+    }
+    results.add(spGetDiagnosticOutput(request));
+    return results;
+}
+
+    /// Compile each permutation with a request of its own
+static List<List<String>> _compileSeparately(SlangSession* session, String& outDiagnostics)
+{
+    List<List<String>> results;
+    for (auto& defines : kPermutationDefines)
+    {
+        SlangCompileRequest* request = _createRequest(session);
+        for (auto& define : defines)
+        {
+            if (define[0])
+            {
+                spAddPreprocessorDefine(request, define[0], define[1]);
+            }
+        }
+        results.add(_getResults(request, spCompile(request)));
+        outDiagnostics.append(spGetDiagnosticOutput(request));
+        spDestroyCompileRequest(request);
+    }
+    return results;
+}
+
+    /// Compile all of the permutations with a single request
+static List<List<String>> _compileBatched(SlangSession* session, int threadCount, String& outDiagnostics)
+{
+    SlangCompileRequest* request = _createRequest(session);
+    spSetBackEndThreadCount(request, threadCount);
+    for (auto& defines : kPermutationDefines)
+    {
+        const int permutationIndex = spAddPermutation(request);
+        for (auto& define : defines)
+        {
+            if (define[0])
+            {
+                spPermutation_addPreprocessorDefine(request, permutationIndex, define[0], define[1]);
+            }
+        }
+    }
+
+    // Fails, because a permutation fails
+    SLANG_CHECK(SLANG_FAILED(spCompile(request)));
+    SLANG_CHECK(spGetPermutationCount(request) == int(SLANG_COUNT_OF(kPermutationDefines)));
+
+    List<List<String>> results;
+    for (int i = 0; i < spGetPermutationCount(request); ++i)
+    {
+        SlangCompileRequest* permutationRequest = spGetPermutationRequest(request, i);
+        const bool hasErrors = UnownedStringSlice(spGetDiagnosticOutput(permutationRequest)).indexOf(UnownedStringSlice::fromLiteral("error")) >= 0;
+        results.add(_getResults(permutationRequest, hasErrors ? SLANG_FAIL : SLANG_OK));
+    }
+    outDiagnostics = spGetDiagnosticOutput(request);
+
+    spDestroyCompileRequest(request);
+    return results;
+}
+
+static void permutationsTest()
+{
+    SlangSession* session = spCreateSession();
+
+    String expectedDiagnostics;
+    const List<List<String>> expected = _compileSeparately(session, expectedDiagnostics);
+
+    // All but the last permutation compile, and they all produce different code
+    SLANG_CHECK(expected.getLast().getCount() == 1);
+    SLANG_CHECK(expectedDiagnostics.getLength() > 0);
+    for (Index i = 0; i < expected.getCount() - 1; ++i)
+    {
+        SLANG_CHECK(expected[i].getCount() == SLANG_COUNT_OF(kTargets) * SLANG_COUNT_OF(kEntryPointNames) + 1);
+        SLANG_CHECK(expected[i][0].getLength() > 0);
+        SLANG_CHECK(i == 0 || expected[i][0] != expected[i - 1][0]);
+    }
+
+    // Compiling them as a batch should produce the same output and diagnostics (in order)
+    for (int threadCount : { 1, 0, 3 })
+    {
+        String diagnostics;
+        const List<List<String>> results = _compileBatched(session, threadCount, diagnostics);
+
+        SLANG_CHECK(diagnostics == expectedDiagnostics);
+        SLANG_CHECK(results.getCount() == expected.getCount());
+        if (results.getCount() == expected.getCount())
+        {
+            for (Index i = 0; i < expected.getCount(); ++i)
+            {
+                SLANG_CHECK(results[i].getCount() == expected[i].getCount());
+                if (results[i].getCount() == expected[i].getCount())
+                {
+                    for (Index j = 0; j < expected[i].getCount(); ++j)
+                    {
+                        SLANG_CHECK(results[i][j] == expected[i][j]);
+                    }
+                }
+            }
+        }
+    }
+
+    spDestroySession(session);
+}
+
+SLANG_UNIT_TEST("permutations", permutationsTest);
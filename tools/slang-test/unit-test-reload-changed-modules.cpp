@@ -0,0 +1,103 @@
+// unit-test-reload-changed-modules.cpp
+
+#include "../../slang.h"
+#include "../../slang-com-ptr.h"
+
+#include "../../source/core/slang-io.h"
+
+#include "test-context.h"
+
+using namespace Slang;
+
+static void _writeModule(const String& directory, const char* fileName, const char* source)
+{
+    File::writeAllText(Path::combine(directory, fileName), source);
+}
+
+static void reloadChangedModulesUnitTest()
+{
+    // Use a uniquely named directory in the temporary directory
+    String directory;
+    SLANG_CHECK_ABORT(SLANG_SUCCEEDED(File::generateTemporary(UnownedStringSlice::fromLiteral("slang-test-reload"), directory)));
+    File::remove(directory);
+    SLANG_CHECK_ABORT(Path::createDirectory(directory));
+
+    _writeModule(directory, "reload-a.slang", "import reload_b;\nint getA() { return getB() + 1; }\n");
+    _writeModule(directory, "reload-b.slang", "int getB() { return 1; }\n");
+    _writeModule(directory, "reload-c.slang", "int getC() { return 3; }\n");
+
+    slang::IGlobalSession* globalSession = spCreateSession();
+
+    const char* searchPaths[] = { directory.getBuffer() };
+
+    slang::SessionDesc sessionDesc;
+    sessionDesc.flags = slang::kSessionFlag_ReloadChangedModules;
+    sessionDesc.searchPaths = searchPaths;
+    sessionDesc.searchPathCount = SLANG_COUNT_OF(searchPaths);
+
+    ComPtr<slang::ISession> session;
+    SLANG_CHECK_ABORT(SLANG_SUCCEEDED(globalSession->createSession(sessionDesc, session.writeRef())));
+
+    // Hold references, so a reloaded module can't be at the same address as the module it replaces
+    ComPtr<slang::IModule> moduleA(session->loadModule("reload_a"));
+    ComPtr<slang::IModule> moduleC(session->loadModule("reload_c"));
+    SLANG_CHECK(moduleA && moduleC);
+
+    // Nothing has changed, so the same modules are used
+    SLANG_CHECK(session->loadModule("reload_a") == moduleA);
+    SLANG_CHECK(session->loadModule("reload_c") == moduleC);
+
+    // Changing the module 'a' imports means 'a' is reloaded, but 'c' is not
+    _writeModule(directory, "reload-b.slang", "int getB() { return 2; }\n");
+    {
+        slang::IModule* reloadedA = session->loadModule("reload_a");
+        SLANG_CHECK(reloadedA && reloadedA != moduleA);
+        SLANG_CHECK(session->loadModule("reload_a") == reloadedA);
+        SLANG_CHECK(session->loadModule("reload_c") == moduleC);
+    }
+
+    // A module that couldn't be found can be loaded once it's added
+    SLANG_CHECK(session->loadModule("reload_e") == nullptr);
+    _writeModule(directory, "reload-e.slang", "int getE() { return 5; }\n");
+    SLANG_CHECK(session->loadModule("reload_e") != nullptr);
+
+    // A module that failed to load can be loaded once it's fixed
+    _writeModule(directory, "reload-d.slang", "int getD() { return undefinedFunction(); }\n");
+    {
+        ComPtr<slang::IBlob> diagnostics;
+        SLANG_CHECK(session->loadModule("reload_d", diagnostics.writeRef()) == nullptr);
+        SLANG_CHECK(diagnostics != nullptr);
+    }
+    _writeModule(directory, "reload-d.slang", "int getD() { return 4; }\n");
+    SLANG_CHECK(session->loadModule("reload_d") != nullptr);
+
+    // Without the flag, the originally loaded module is always used
+    {
+        slang::SessionDesc plainSessionDesc;
+        plainSessionDesc.searchPaths = searchPaths;
+        plainSessionDesc.searchPathCount = SLANG_COUNT_OF(searchPaths);
+
+        ComPtr<slang::ISession> plainSession;
+        SLANG_CHECK_ABORT(SLANG_SUCCEEDED(globalSession->createSession(plainSessionDesc, plainSession.writeRef())));
+
+        ComPtr<slang::IModule> plainModuleA(plainSession->loadModule("reload_a"));
+        SLANG_CHECK(plainModuleA);
+
+        _writeModule(directory, "reload-b.slang", "int getB() { return 3; }\n");
+        SLANG_CHECK(plainSession->loadModule("reload_a") == plainModuleA);
+    }
+
+    moduleA.setNull();
+    moduleC.setNull();
+    session.setNull();
+    spDestroySession(globalSession);
+
+    const char* const fileNames[] = { "reload-a.slang", "reload-b.slang", "reload-c.slang", "reload-d.slang", "reload-e.slang" };
+    for (auto fileName : fileNames)
+    {
+        File::remove(Path::combine(directory, fileName));
+    }
+    File::remove(directory);
+}
+
+SLANG_UNIT_TEST("ReloadChangedModules", reloadChangedModulesUnitTest);
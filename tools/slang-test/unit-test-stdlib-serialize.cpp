@@ -0,0 +1,60 @@
+// unit-test-stdlib-serialize.cpp
+
+#include "../../slang.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../slang-com-ptr.h"
+
+#include "test-context.h"
+
+using namespace Slang;
+
+static void stdLibSerializeTest()
+{
+    // Save the stdlib from a session that compiled it
+    ComPtr<ISlangBlob> stdLibBlob;
+    {
+        ComPtr<slang::IGlobalSession> session;
+        SLANG_CHECK_ABORT(SLANG_SUCCEEDED(slang_createGlobalSession(SLANG_API_VERSION, session.writeRef())));
+        SLANG_CHECK_ABORT(SLANG_SUCCEEDED(session->saveStdLib(stdLibBlob.writeRef())));
+        SLANG_CHECK_ABORT(stdLibBlob && stdLibBlob->getBufferSize() > 0);
+
+        // A stdlib is already present, so neither compiling nor loading should be possible
+        SLANG_CHECK(SLANG_FAILED(session->compileStdLib()));
+        SLANG_CHECK(SLANG_FAILED(session->loadStdLib(stdLibBlob->getBufferPointer(), stdLibBlob->getBufferSize())));
+    }
+
+    // Load it into a session without a stdlib, and check it is usable
+    {
+        ComPtr<slang::IGlobalSession> session;
+        SLANG_CHECK_ABORT(SLANG_SUCCEEDED(slang_createGlobalSessionWithoutStdLib(SLANG_API_VERSION, session.writeRef())));
+
+        // Corrupt data must be rejected
+        const uint8_t junk[64] = {};
+        SLANG_CHECK(SLANG_FAILED(session->loadStdLib(junk, sizeof(junk))));
+
+        SLANG_CHECK_ABORT(SLANG_SUCCEEDED(session->loadStdLib(stdLibBlob->getBufferPointer(), stdLibBlob->getBufferSize())));
+
+        const char* testSource =
+            "RWStructuredBuffer<float> outputBuffer;"
+            "[numthreads(4, 1, 1)]"
+            "void computeMain(uint3 tid : SV_DispatchThreadID)"
+            "{"
+            "    outputBuffer[tid.x] = sqrt(float(tid.x)) + dot(float2(1, 2), float2(3, 4));"
+            "}";
+
+        SlangCompileRequest* request = spCreateCompileRequest((SlangSession*)session.get());
+        spAddCodeGenTarget(request, SLANG_HLSL);
+        int tuIndex = spAddTranslationUnit(request, SLANG_SOURCE_LANGUAGE_SLANG, "tu1");
+        spAddTranslationUnitSourceString(request, tuIndex, "internalFile", testSource);
+        spAddEntryPoint(request, tuIndex, "computeMain", SLANG_STAGE_COMPUTE);
+
+        SLANG_CHECK(SLANG_SUCCEEDED(spCompile(request)));
+
+        spDestroyCompileRequest(request);
+    }
+}
+
+SLANG_UNIT_TEST("stdLibSerialize", stdLibSerializeTest);